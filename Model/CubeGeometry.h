@@ -0,0 +1,50 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "RubiksCube.h"
+using namespace std;
+
+#ifndef CUBEGEOMETRY_H
+#define CUBEGEOMETRY_H
+
+// Where the stickers of every corner and edge sit, shared by everything that reads
+// pieces off a cube so the tables cannot drift apart.
+
+struct Facelet
+{
+    RubiksCube::FACE face;
+    unsigned row;
+    unsigned col;
+};
+
+// U/D sticker first, then F/B, then L/R, matching getCornerColorString.
+inline constexpr Facelet CORNER_FACELETS[8][3] = {
+    {{RubiksCube::FACE::UP, 2, 2}, {RubiksCube::FACE::FRONT, 0, 2}, {RubiksCube::FACE::RIGHT, 0, 0}},
+    {{RubiksCube::FACE::UP, 2, 0}, {RubiksCube::FACE::FRONT, 0, 0}, {RubiksCube::FACE::LEFT, 0, 2}},
+    {{RubiksCube::FACE::UP, 0, 0}, {RubiksCube::FACE::BACK, 0, 2}, {RubiksCube::FACE::LEFT, 0, 0}},
+    {{RubiksCube::FACE::UP, 0, 2}, {RubiksCube::FACE::BACK, 0, 0}, {RubiksCube::FACE::RIGHT, 0, 2}},
+    {{RubiksCube::FACE::DOWN, 0, 2}, {RubiksCube::FACE::FRONT, 2, 2}, {RubiksCube::FACE::RIGHT, 2, 0}},
+    {{RubiksCube::FACE::DOWN, 0, 0}, {RubiksCube::FACE::FRONT, 2, 0}, {RubiksCube::FACE::LEFT, 2, 2}},
+    {{RubiksCube::FACE::DOWN, 2, 2}, {RubiksCube::FACE::BACK, 2, 0}, {RubiksCube::FACE::RIGHT, 2, 2}},
+    {{RubiksCube::FACE::DOWN, 2, 0}, {RubiksCube::FACE::BACK, 2, 2}, {RubiksCube::FACE::LEFT, 2, 0}},
+};
+
+// Whether the U/D, F/B, L/R stickers of the corner at each position run clockwise around it.
+inline constexpr bool CORNER_CLOCKWISE[8] = {false, true, false, true, true, false, false, true};
+
+// Primary (U/D, or F/B in the middle layer) sticker first, matching getEdgeColorString.
+inline constexpr Facelet EDGE_FACELETS[12][2] = {
+    {{RubiksCube::FACE::UP, 2, 1}, {RubiksCube::FACE::FRONT, 0, 1}},
+    {{RubiksCube::FACE::UP, 1, 0}, {RubiksCube::FACE::LEFT, 0, 1}},
+    {{RubiksCube::FACE::UP, 0, 1}, {RubiksCube::FACE::BACK, 0, 1}},
+    {{RubiksCube::FACE::UP, 1, 2}, {RubiksCube::FACE::RIGHT, 0, 1}},
+    {{RubiksCube::FACE::FRONT, 1, 2}, {RubiksCube::FACE::RIGHT, 1, 0}},
+    {{RubiksCube::FACE::FRONT, 1, 0}, {RubiksCube::FACE::LEFT, 1, 2}},
+    {{RubiksCube::FACE::BACK, 1, 2}, {RubiksCube::FACE::LEFT, 1, 0}},
+    {{RubiksCube::FACE::BACK, 1, 0}, {RubiksCube::FACE::RIGHT, 1, 2}},
+    {{RubiksCube::FACE::DOWN, 0, 1}, {RubiksCube::FACE::FRONT, 2, 1}},
+    {{RubiksCube::FACE::DOWN, 1, 0}, {RubiksCube::FACE::LEFT, 2, 1}},
+    {{RubiksCube::FACE::DOWN, 2, 1}, {RubiksCube::FACE::BACK, 2, 1}},
+    {{RubiksCube::FACE::DOWN, 1, 2}, {RubiksCube::FACE::RIGHT, 2, 1}},
+};
+
+#endif //CUBEGEOMETRY_H
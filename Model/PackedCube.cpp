@@ -0,0 +1,156 @@
+#include "PackedCube.h"
+#include "CubeGeometry.h"
+#include "../PatternDatabases/PermutationIndexer.h"
+
+namespace
+{
+    // Every face starts out in the color with the same index.
+    RubiksCube::COLOR getHomeColor(const Facelet& facelet)
+    {
+        return static_cast<RubiksCube::COLOR>(static_cast<int>(facelet.face));
+    }
+
+    RubiksCube::COLOR getColor(const RubiksCube& cube, const Facelet& facelet)
+    {
+        return cube.getColor(facelet.face, facelet.row, facelet.col);
+    }
+
+    void setColor(RubiksCube& cube, const Facelet& facelet, const RubiksCube::COLOR color)
+    {
+        cube.setColor(facelet.face, facelet.row, facelet.col, color);
+    }
+
+    // Home position of the piece with each set of colors, indexed by the bitmask of those colors.
+    template <size_t N, size_t M>
+    constexpr array<int8_t, 64> makeHomeTable(const Facelet (&facelets)[M][N])
+    {
+        array<int8_t, 64> table{};
+        table.fill(-1);
+        for (size_t home = 0; home < M; ++home)
+        {
+            uint32_t mask = 0;
+            for (const Facelet& facelet : facelets[home])
+            {
+                mask |= 1u << static_cast<int>(facelet.face);
+            }
+            table[mask] = static_cast<int8_t>(home);
+        }
+        return table;
+    }
+
+    constexpr array<int8_t, 64> CORNER_HOMES = makeHomeTable(CORNER_FACELETS);
+    constexpr array<int8_t, 64> EDGE_HOMES = makeHomeTable(EDGE_FACELETS);
+
+    template <size_t N>
+    int findHome(const array<int8_t, 64>& homes, const array<RubiksCube::COLOR, N>& colors)
+    {
+        uint32_t mask = 0;
+        for (const RubiksCube::COLOR color : colors)
+        {
+            mask |= 1u << static_cast<int>(color);
+        }
+        return homes[mask];
+    }
+
+    bool isUpDownColor(const RubiksCube::COLOR color)
+    {
+        return color == RubiksCube::COLOR::WHITE || color == RubiksCube::COLOR::YELLOW;
+    }
+}
+
+PackedCube PackedCube::pack(const RubiksCube& cube)
+{
+    array<uint8_t, 8> cornerPerm{};
+    uint64_t twists = 0;
+    for (uint8_t slot = 0; slot < 8; ++slot)
+    {
+        array<RubiksCube::COLOR, 3> colors{};
+        uint8_t upDownSticker = 0;
+        for (uint8_t k = 0; k < 3; ++k)
+        {
+            colors[k] = getColor(cube, CORNER_FACELETS[slot][k]);
+            if (isUpDownColor(colors[k]))
+            {
+                upDownSticker = k;
+            }
+        }
+        cornerPerm[slot] = findHome(CORNER_HOMES, colors);
+        if (slot < 7)
+        {
+            const uint8_t twist = CORNER_CLOCKWISE[slot] ? upDownSticker : (3 - upDownSticker) % 3;
+            twists = twists * 3 + twist;
+        }
+    }
+
+    array<uint8_t, 12> edgePerm{};
+    uint64_t flips = 0;
+    for (uint8_t slot = 0; slot < 12; ++slot)
+    {
+        const array colors = {getColor(cube, EDGE_FACELETS[slot][0]), getColor(cube, EDGE_FACELETS[slot][1])};
+        const int home = findHome(EDGE_HOMES, colors);
+        edgePerm[slot] = home;
+        if (slot < 11)
+        {
+            // The piece is unflipped when its primary color sits on the primary sticker.
+            const bool flipped = colors[0] != getHomeColor(EDGE_FACELETS[home][0]);
+            flips = (flips << 1) | flipped;
+        }
+    }
+
+    return {
+        PermutationIndexer<8>::rank(cornerPerm) * 2187ull + twists,
+        PermutationIndexer<12>::rank(edgePerm) * 2048ull + flips
+    };
+}
+
+void PackedCube::unpack(RubiksCube& cube) const
+{
+    const array<uint8_t, 8> cornerPerm = PermutationIndexer<8>::unrank(this->corners / 2187);
+    array<uint8_t, 8> twists{};
+    uint64_t twistDigits = this->corners % 2187;
+    uint8_t twistSum = 0;
+    for (int slot = 6; slot >= 0; --slot)
+    {
+        twists[slot] = twistDigits % 3;
+        twistDigits /= 3;
+        twistSum += twists[slot];
+    }
+    twists[7] = (3 - twistSum % 3) % 3;
+    for (uint8_t slot = 0; slot < 8; ++slot)
+    {
+        const uint8_t home = cornerPerm[slot];
+        // Walk the stickers of both the piece and the slot clockwise, starting from
+        // the piece's U/D sticker, which sits `twist` clockwise steps into the slot.
+        const array<uint8_t, 3> pieceOrder = CORNER_CLOCKWISE[home] ? array<uint8_t, 3>{0, 1, 2} : array<uint8_t, 3>{0, 2, 1};
+        const array<uint8_t, 3> slotOrder = CORNER_CLOCKWISE[slot] ? array<uint8_t, 3>{0, 1, 2} : array<uint8_t, 3>{0, 2, 1};
+        for (uint8_t k = 0; k < 3; ++k)
+        {
+            const RubiksCube::COLOR color = getHomeColor(CORNER_FACELETS[home][pieceOrder[k]]);
+            setColor(cube, CORNER_FACELETS[slot][slotOrder[(twists[slot] + k) % 3]], color);
+        }
+    }
+
+    const array<uint8_t, 12> edgePerm = PermutationIndexer<12>::unrank(this->edges / 2048);
+    uint64_t flipBits = this->edges % 2048;
+    for (int slot = 11; slot >= 0; --slot)
+    {
+        uint8_t flip;
+        if (slot == 11)
+        {
+            flip = popcount(flipBits) % 2;
+        }
+        else
+        {
+            flip = flipBits & 1;
+            flipBits >>= 1;
+        }
+        const uint8_t home = edgePerm[slot];
+        setColor(cube, EDGE_FACELETS[slot][flip], getHomeColor(EDGE_FACELETS[home][0]));
+        setColor(cube, EDGE_FACELETS[slot][1 - flip], getHomeColor(EDGE_FACELETS[home][1]));
+    }
+}
+
+PackedCube PackedCube::solved()
+{
+    return {0, 0};
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "RubiksCube.h"
+using namespace std;
+
+#ifndef PACKEDCUBE_H
+#define PACKEDCUBE_H
+
+/*
+ * Canonical 128-bit encoding of a full cube state, independent of the model it came from.
+ *
+ * corners = rank of the corner permutation * 3^7 + twists of the first 7 corners
+ * edges   = rank of the edge permutation * 2^11 + flips of the first 11 edges
+ *
+ * The last twist and flip follow from the others, so the state takes 66 bits
+ * of the 128. Corners and edges are numbered as in getCornerColorString and
+ * getEdgeColorString, and a corner's twist counts clockwise turns of its U/D sticker.
+ */
+struct PackedCube
+{
+    uint64_t corners;
+    uint64_t edges;
+
+    [[nodiscard]] static PackedCube pack(const RubiksCube& cube);
+
+    // Repaints every corner and edge sticker of cube, the centers are left as they are.
+    void unpack(RubiksCube& cube) const;
+
+    [[nodiscard]] static PackedCube solved();
+
+    auto operator<=>(const PackedCube&) const = default;
+};
+
+struct HashPackedCube
+{
+    size_t operator()(const PackedCube& packedCube) const
+    {
+        return (packedCube.corners * 0x9E3779B97F4A7C15ull) ^ (packedCube.edges * 0xC2B2AE3D27D4EB4Full);
+    }
+};
+
+#endif //PACKEDCUBE_H
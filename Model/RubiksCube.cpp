@@ -1,4 +1,5 @@
 #include "RubiksCube.h"
+#include "ScrambleGenerator.h"
 
 /**
  * Returns the first letter of the given COLOR eg- For COLOR::GREEN, it returns 'G'
@@ -52,6 +53,66 @@ string RubiksCube::getMove(const MOVE move)
     }
 }
 
+/**
+ * Returns the move that undoes the given move.
+ *
+ * Quarter turns are swapped with their primes and half turns are their own
+ * inverse, eg- the inverse of L is LPRIME and the inverse of L2 is L2.
+ *
+ * @param move the move to be inverted
+ * @return the inverse of the given move
+ */
+RubiksCube::MOVE RubiksCube::getInverseMove(const MOVE move)
+{
+    const int ind = static_cast<int>(move);
+    switch (ind % 3)
+    {
+    case 0: return static_cast<MOVE>(ind + 1);
+    case 1: return static_cast<MOVE>(ind - 1);
+    default: return move;
+    }
+}
+
+/**
+ * Parses a single move in WCA notation.
+ *
+ * A face letter is followed by nothing for a clockwise quarter turn, ' for a
+ * counter-clockwise one or 2 for a half turn. 2' is accepted as a half turn too.
+ *
+ * @param notation the move, eg- "R", "U'" or "F2"
+ * @return the parsed move
+ */
+RubiksCube::MOVE RubiksCube::parseMove(const string& notation)
+{
+    constexpr string_view faces = "LRUDFB";
+    const size_t face = notation.empty() ? string_view::npos : faces.find(notation[0]);
+    const string_view suffix = string_view(notation).substr(min<size_t>(1, notation.size()));
+    if (face == string_view::npos || (suffix != "" && suffix != "'" && suffix != "2" && suffix != "2'"))
+    {
+        throw invalid_argument("Invalid move \"" + notation + "\"");
+    }
+    const int turn = suffix.empty() ? 0 : suffix == "'" ? 1 : 2;
+    return static_cast<MOVE>(face * 3 + turn);
+}
+
+/**
+ * Parses a sequence of moves in WCA notation separated by whitespace.
+ *
+ * @param sequence the moves, eg- "R U' F2"
+ * @return the parsed moves, in order
+ */
+vector<RubiksCube::MOVE> RubiksCube::parseMoves(const string& sequence)
+{
+    vector<MOVE> moves;
+    istringstream stream(sequence);
+    string notation;
+    while (stream >> notation)
+    {
+        moves.push_back(parseMove(notation));
+    }
+    return moves;
+}
+
 /**
  * Applies a single move to the cube.
  *
@@ -191,11 +252,13 @@ void RubiksCube::print() const
  */
 vector<RubiksCube::MOVE> RubiksCube::randomShuffleCube(const unsigned int times)
 {
+    // One generator per thread, seeded from the system, so calls never share state and
+    // two calls in the same second still give different scrambles.
+    thread_local ScrambleGenerator generator(ScrambleGenerator::randomSeed());
     vector<MOVE> performedMoves;
-    srand(time(nullptr));
     for (unsigned i = 0; i < times; i++)
     {
-        auto currentMove = static_cast<MOVE>(rand() % 18);
+        auto currentMove = static_cast<MOVE>(generator.nextBelow(18));
         performedMoves.push_back(currentMove);
         this->move(currentMove);
     }
@@ -338,3 +401,168 @@ uint8_t RubiksCube::getCornerOrientation(const uint8_t ind) const
         return 2;
     return 0;
 }
+
+
+/**
+ * Returns the color string of the given edge index.
+ *
+ * The indices are assigned as follows:
+ * 0 - UF
+ * 1 - UL
+ * 2 - UB
+ * 3 - UR
+ * 4 - FR
+ * 5 - FL
+ * 6 - BL
+ * 7 - BR
+ * 8 - DF
+ * 9 - DL
+ * 10 - DB
+ * 11 - DR
+ *
+ * @param ind the index of the edge
+ * @return a string of the colors of the edge, the U/D (or F/B for the middle layer) sticker first
+ */
+string RubiksCube::getEdgeColorString(const uint8_t ind) const
+{
+    string edgeColorString;
+    switch (ind)
+    {
+    // UF
+    case 0:
+        edgeColorString += getColorLetter(getColor(FACE::UP, 2, 1));
+        edgeColorString += getColorLetter(getColor(FACE::FRONT, 0, 1));
+        break;
+    // UL
+    case 1:
+        edgeColorString += getColorLetter(getColor(FACE::UP, 1, 0));
+        edgeColorString += getColorLetter(getColor(FACE::LEFT, 0, 1));
+        break;
+    // UB
+    case 2:
+        edgeColorString += getColorLetter(getColor(FACE::UP, 0, 1));
+        edgeColorString += getColorLetter(getColor(FACE::BACK, 0, 1));
+        break;
+    // UR
+    case 3:
+        edgeColorString += getColorLetter(getColor(FACE::UP, 1, 2));
+        edgeColorString += getColorLetter(getColor(FACE::RIGHT, 0, 1));
+        break;
+    // FR
+    case 4:
+        edgeColorString += getColorLetter(getColor(FACE::FRONT, 1, 2));
+        edgeColorString += getColorLetter(getColor(FACE::RIGHT, 1, 0));
+        break;
+    // FL
+    case 5:
+        edgeColorString += getColorLetter(getColor(FACE::FRONT, 1, 0));
+        edgeColorString += getColorLetter(getColor(FACE::LEFT, 1, 2));
+        break;
+    // BL
+    case 6:
+        edgeColorString += getColorLetter(getColor(FACE::BACK, 1, 2));
+        edgeColorString += getColorLetter(getColor(FACE::LEFT, 1, 0));
+        break;
+    // BR
+    case 7:
+        edgeColorString += getColorLetter(getColor(FACE::BACK, 1, 0));
+        edgeColorString += getColorLetter(getColor(FACE::RIGHT, 1, 2));
+        break;
+    // DF
+    case 8:
+        edgeColorString += getColorLetter(getColor(FACE::DOWN, 0, 1));
+        edgeColorString += getColorLetter(getColor(FACE::FRONT, 2, 1));
+        break;
+    // DL
+    case 9:
+        edgeColorString += getColorLetter(getColor(FACE::DOWN, 1, 0));
+        edgeColorString += getColorLetter(getColor(FACE::LEFT, 2, 1));
+        break;
+    // DB
+    case 10:
+        edgeColorString += getColorLetter(getColor(FACE::DOWN, 2, 1));
+        edgeColorString += getColorLetter(getColor(FACE::BACK, 2, 1));
+        break;
+    // DR
+    case 11:
+        edgeColorString += getColorLetter(getColor(FACE::DOWN, 1, 2));
+        edgeColorString += getColorLetter(getColor(FACE::RIGHT, 2, 1));
+        break;
+    default:
+        edgeColorString = "";
+        break;
+    }
+    return edgeColorString;
+}
+
+/**
+ * Returns the home position of the edge currently at index ind.
+ *
+ * The edge is identified by its pair of colors, and the returned value uses
+ * the same numbering as getEdgeColorString eg- the White/Red edge is 0 (UF).
+ *
+ * @param ind the index of the edge
+ * @return the index of the position where the edge belongs in the solved cube
+ */
+uint8_t RubiksCube::getEdgeIndex(const uint8_t ind) const
+{
+    const string edgeColorString = getEdgeColorString(ind);
+    uint8_t colorMask = 0;
+    for (const char c : edgeColorString)
+    {
+        switch (c)
+        {
+        case 'W': colorMask |= (1 << 0);
+            break;
+        case 'G': colorMask |= (1 << 1);
+            break;
+        case 'R': colorMask |= (1 << 2);
+            break;
+        case 'B': colorMask |= (1 << 3);
+            break;
+        case 'O': colorMask |= (1 << 4);
+            break;
+        case 'Y': colorMask |= (1 << 5);
+            break;
+        default: break;
+        }
+    }
+    switch (colorMask)
+    {
+    case 0b000101: return 0;
+    case 0b000011: return 1;
+    case 0b010001: return 2;
+    case 0b001001: return 3;
+    case 0b001100: return 4;
+    case 0b000110: return 5;
+    case 0b010010: return 6;
+    case 0b011000: return 7;
+    case 0b100100: return 8;
+    case 0b100010: return 9;
+    case 0b110000: return 10;
+    case 0b101000: return 11;
+    default: return 0xFF;
+    }
+}
+
+/**
+ * Returns the orientation of the edge at index ind.
+ *
+ * Every edge has a primary color, White/Yellow if it has one and Red/Orange
+ * otherwise. The edge is oriented (0) when its primary color lies on the first
+ * sticker of getEdgeColorString, and flipped (1) otherwise.
+ *
+ * @param ind the index of the edge
+ * @return the orientation of the edge
+ */
+uint8_t RubiksCube::getEdgeOrientation(const uint8_t ind) const
+{
+    const string edgeColorString = getEdgeColorString(ind);
+    const bool hasUpDownColor = edgeColorString.find_first_of("WY") != string::npos;
+    const char first = edgeColorString[0];
+    if (hasUpDownColor)
+    {
+        return (first == 'W' || first == 'Y') ? 0 : 1;
+    }
+    return (first == 'R' || first == 'O') ? 0 : 1;
+}
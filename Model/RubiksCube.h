@@ -44,6 +44,10 @@ public:
     * Returns the color of the cell at (row, col) in face.
     */
     [[nodiscard]] virtual COLOR getColor(FACE face, unsigned int row, unsigned int col) const = 0;
+    /*
+    * Sets the color of the cell at (row, col) in face. Center cells are fixed and are left unchanged.
+    */
+    virtual void setColor(FACE face, unsigned int row, unsigned int col, COLOR color) = 0;
     // static: Indicates that the method belongs to the class itself rather than an instance of the class.
     /*
     * Returns the first letter of the given COLOR eg- For COLOR::GREEN, it returns 'G'
@@ -57,6 +61,18 @@ public:
     * Returns the move in the string format eg- "L", "LPRIME", "L2", "D"...
     */
     static string getMove(MOVE move);
+    /*
+    * Returns the move that undoes the given move eg- For MOVE::L, it returns MOVE::LPRIME
+    */
+    static MOVE getInverseMove(MOVE move);
+    /*
+    * Parses a move in WCA notation eg- "R", "U'", "F2", throwing invalid_argument if it is not one
+    */
+    static MOVE parseMove(const string& notation);
+    /*
+    * Parses a whitespace separated sequence of moves in WCA notation eg- "R U' F2"
+    */
+    static vector<MOVE> parseMoves(const string& sequence);
     /*
      * Print the Rubik's Cube in Planar format. The cube is laid out as follows.
      *
@@ -141,6 +157,10 @@ public:
     [[nodiscard]] string getCornerColorString(uint8_t ind) const;
     [[nodiscard]] uint8_t getCornerIndex(uint8_t ind) const;
     [[nodiscard]] uint8_t getCornerOrientation(uint8_t ind) const;
+
+    [[nodiscard]] string getEdgeColorString(uint8_t ind) const;
+    [[nodiscard]] uint8_t getEdgeIndex(uint8_t ind) const;
+    [[nodiscard]] uint8_t getEdgeOrientation(uint8_t ind) const;
 };
 
 #endif //RUBIKSCUBE_H
@@ -0,0 +1,211 @@
+#include "RubiksCube.h"
+#include "PackedCube.h"
+#include "../PatternDatabases/PermutationIndexer.h"
+
+/*
+ * The 2x2x2 pocket cube, stored as the coordinates of its corners.
+ *
+ * A 2x2 has no centers, so its state is only defined up to whole cube rotations.
+ * It is kept in the frame where the down-back-left corner never moves. L, D and B
+ * turn the same layers as R, U and F relative to that corner, so they act like
+ * them. The other seven corners give 7! * 3^6 = 3674160 states.
+ *
+ * Corners are numbered as in getCornerColorString, with DBL last, and a twist
+ * counts clockwise turns of the corner's U/D sticker.
+ */
+class RubiksCube2x2
+{
+    struct MoveTables
+    {
+        array<array<uint16_t, 9>, 5040> permutation;
+        array<array<uint16_t, 9>, 729> orientation;
+    };
+
+    // For each quarter turn, the slot every corner comes from and the twist it picks up.
+    struct CornerMove
+    {
+        array<uint8_t, 7> from;
+        array<uint8_t, 7> twist;
+    };
+
+    static constexpr CornerMove QUARTER_TURNS[3] = {
+        {{3, 0, 1, 2, 4, 5, 6}, {0, 0, 0, 0, 0, 0, 0}}, // U
+        {{4, 1, 2, 0, 6, 5, 3}, {2, 0, 0, 1, 1, 0, 2}}, // R
+        {{1, 5, 2, 3, 0, 4, 6}, {1, 2, 0, 0, 2, 1, 0}}, // F
+    };
+
+    // Generators run X, X', X2, so one quarter turn is offset 0, two are 2 and three are 1.
+    static constexpr int TURNS_TO_OFFSET[4] = {0, 0, 2, 1};
+
+    static const MoveTables& getMoveTables()
+    {
+        static const MoveTables tables = []
+        {
+            MoveTables result{};
+            for (uint16_t rank = 0; rank < 5040; ++rank)
+            {
+                for (int face = 0; face < 3; ++face)
+                {
+                    array<uint8_t, 7> perm = PermutationIndexer<7>::unrank(rank);
+                    for (int turns = 1; turns <= 3; ++turns)
+                    {
+                        array<uint8_t, 7> next{};
+                        for (int slot = 0; slot < 7; ++slot)
+                        {
+                            next[slot] = perm[QUARTER_TURNS[face].from[slot]];
+                        }
+                        perm = next;
+                        result.permutation[rank][face * 3 + TURNS_TO_OFFSET[turns]] = PermutationIndexer<7>::rank(perm);
+                    }
+                }
+            }
+            for (uint16_t coordinate = 0; coordinate < 729; ++coordinate)
+            {
+                for (int face = 0; face < 3; ++face)
+                {
+                    array<uint8_t, 7> twists = decodeTwists(coordinate);
+                    for (int turns = 1; turns <= 3; ++turns)
+                    {
+                        array<uint8_t, 7> next{};
+                        for (int slot = 0; slot < 7; ++slot)
+                        {
+                            const CornerMove& quarterTurn = QUARTER_TURNS[face];
+                            next[slot] = (twists[quarterTurn.from[slot]] + quarterTurn.twist[slot]) % 3;
+                        }
+                        twists = next;
+                        result.orientation[coordinate][face * 3 + TURNS_TO_OFFSET[turns]] = encodeTwists(twists);
+                    }
+                }
+            }
+            return result;
+        }();
+        return tables;
+    }
+
+    static array<uint8_t, 7> decodeTwists(uint16_t coordinate)
+    {
+        array<uint8_t, 7> twists{};
+        uint8_t sum = 0;
+        for (int slot = 5; slot >= 0; --slot)
+        {
+            twists[slot] = coordinate % 3;
+            coordinate /= 3;
+            sum += twists[slot];
+        }
+        // The fixed corner is never twisted, so the other seven add up to a whole turn.
+        twists[6] = (3 - sum % 3) % 3;
+        return twists;
+    }
+
+    static uint16_t encodeTwists(const array<uint8_t, 7>& twists)
+    {
+        uint16_t coordinate = 0;
+        for (int slot = 0; slot < 6; ++slot)
+        {
+            coordinate = coordinate * 3 + twists[slot];
+        }
+        return coordinate;
+    }
+
+    uint16_t permutation = 0;
+    uint16_t orientation = 0;
+
+public:
+    static constexpr uint32_t NUM_STATES = 5040 * 729;
+    static constexpr int NUM_GENERATORS = 9;
+    // The moves the frame is closed under, in generator order.
+    static constexpr RubiksCube::MOVE GENERATORS[NUM_GENERATORS] = {
+        RubiksCube::MOVE::U, RubiksCube::MOVE::UPRIME, RubiksCube::MOVE::U2,
+        RubiksCube::MOVE::R, RubiksCube::MOVE::RPRIME, RubiksCube::MOVE::R2,
+        RubiksCube::MOVE::F, RubiksCube::MOVE::FPRIME, RubiksCube::MOVE::F2,
+    };
+
+    /**
+     * Maps any of the 18 moves to the generator it acts as in the fixed-corner frame.
+     *
+     * @param move the move to map
+     * @return the index of the move in GENERATORS
+     */
+    static int getGenerator(const RubiksCube::MOVE move)
+    {
+        const int ind = static_cast<int>(move);
+        // Faces run L, R, U, D, F, B in the MOVE enum.
+        constexpr int faceToGenerator[6] = {1, 1, 0, 0, 2, 2};
+        return faceToGenerator[ind / 3] * 3 + ind % 3;
+    }
+
+    /**
+     * Reads the corners of a 3x3 cube whose down-back-left corner is solved.
+     *
+     * @param cube the cube to read
+     * @return the pocket cube with the same corners
+     * @throws invalid_argument if the down-back-left corner is not solved
+     */
+    static RubiksCube2x2 fromCube(const RubiksCube& cube)
+    {
+        const PackedCube packed = PackedCube::pack(cube);
+        const array<uint8_t, 8> perm = PermutationIndexer<8>::unrank(packed.corners / 2187);
+        const uint32_t twists = packed.corners % 2187;
+        // DBL is untwisted exactly when the twists of the other seven add up to whole turns.
+        uint32_t digits = twists, sum = 0;
+        for (int slot = 0; slot < 7; ++slot)
+        {
+            sum += digits % 3;
+            digits /= 3;
+        }
+        if (perm[7] != 7 || sum % 3 != 0)
+        {
+            throw invalid_argument("The down-back-left corner of the cube must be solved");
+        }
+        RubiksCube2x2 result;
+        result.permutation = PermutationIndexer<7>::rank({perm[0], perm[1], perm[2], perm[3], perm[4], perm[5], perm[6]});
+        result.orientation = twists / 3;
+        return result;
+    }
+
+    static RubiksCube2x2 fromIndex(const uint32_t index)
+    {
+        RubiksCube2x2 result;
+        result.permutation = index / 729;
+        result.orientation = index % 729;
+        return result;
+    }
+
+    [[nodiscard]] uint32_t getIndex() const
+    {
+        return this->permutation * 729u + this->orientation;
+    }
+
+    [[nodiscard]] bool isSolved() const
+    {
+        return this->permutation == 0 && this->orientation == 0;
+    }
+
+    /**
+     * Returns the cube after applying a generator, without changing this one.
+     *
+     * @param generator the index of the move in GENERATORS
+     * @return the resulting cube
+     */
+    [[nodiscard]] RubiksCube2x2 getChild(const int generator) const
+    {
+        const MoveTables& tables = getMoveTables();
+        RubiksCube2x2 child;
+        child.permutation = tables.permutation[this->permutation][generator];
+        child.orientation = tables.orientation[this->orientation][generator];
+        return child;
+    }
+
+    RubiksCube2x2& move(const RubiksCube::MOVE move)
+    {
+        *this = this->getChild(getGenerator(move));
+        return *this;
+    }
+
+    RubiksCube2x2& invert(const RubiksCube::MOVE move)
+    {
+        return this->move(RubiksCube::getInverseMove(move));
+    }
+
+    bool operator==(const RubiksCube2x2&) const = default;
+};
@@ -82,6 +82,23 @@ public:
         }
     }
 
+    /**
+     * Sets the color of a specific cell on the cube.
+     *
+     * @param face the face of the cube
+     * @param row the row index of the cell
+     * @param col the column index of the cell
+     * @param color the new color of the cell
+     */
+    void setColor(FACE face, const unsigned int row, const unsigned int col, const COLOR color) override
+    {
+        if (row == 1 && col == 1)
+        {
+            return;
+        }
+        cube[static_cast<int>(face)][row][col] = getColorLetter(color);
+    }
+
     /**
      * Checks if the cube is solved.
      *
@@ -1,15 +1,26 @@
 #include "RubiksCube.h"
 
-class RubiksCubeBitboard : public RubiksCube
+class RubiksCubeBitboard final : public RubiksCube
 {
-    uint64_t solved_side_config[6]{};
-    int arr[3][3] = {
+    // Maps a (row, col) cell of a face to its byte in the face's bitboard, 8 is the fixed center.
+    static constexpr int arr[3][3] = {
         {0, 1, 2},
         {7, 8, 3},
         {6, 5, 4}
     };
 
-    uint64_t one_8 = (1 << 8) - 1, one_24 = (1 << 24) - 1;
+    static constexpr uint64_t one_8 = (1 << 8) - 1, one_24 = (1 << 24) - 1;
+
+    // Every byte of a solved face holds the face's own color.
+    static constexpr array<uint64_t, 6> solved_side_config = []
+    {
+        array<uint64_t, 6> config{};
+        for (int side = 0; side < 6; side++)
+        {
+            config[side] = 0x0101010101010101ull << side;
+        }
+        return config;
+    }();
 
     void rotateFace(const int ind)
     {
@@ -74,21 +85,11 @@ class RubiksCubeBitboard : public RubiksCube
     }
 
 public:
-    uint64_t bitboard[6]{};
-
-    RubiksCubeBitboard()
-    {
-        for (int side = 0; side < 6; side++)
-        {
-            const uint64_t clr = 1 << side;
-            bitboard[side] = 0;
-            for (int faceIdx = 0; faceIdx < 8; faceIdx++)
-            {
-                bitboard[side] |= clr << (8 * faceIdx);
-            }
-            solved_side_config[side] = bitboard[side];
-        }
-    }
+    // The state is just these six words, the rest of the object is the vtable pointer.
+    uint64_t bitboard[6] = {
+        solved_side_config[0], solved_side_config[1], solved_side_config[2],
+        solved_side_config[3], solved_side_config[4], solved_side_config[5]
+    };
 
     [[nodiscard]] COLOR getColor(FACE face, const unsigned int row, const unsigned int col) const override
     {
@@ -98,14 +99,21 @@ public:
             return static_cast<COLOR>(static_cast<int>(face));
         }
         const uint64_t side = bitboard[static_cast<int>(face)];
-        uint64_t color = (side >> (8 * idx)) & one_8;
-        int bit_pos = 0;
-        while (color != 0)
+        // Each cell holds its color as a single set bit.
+        const uint64_t color = (side >> (8 * idx)) & one_8;
+        return static_cast<COLOR>(countr_zero(color));
+    }
+
+    void setColor(FACE face, const unsigned int row, const unsigned int col, const COLOR color) override
+    {
+        const int idx = arr[row][col];
+        if (idx == 8)
         {
-            color = color >> 1;
-            bit_pos++;
+            return;
         }
-        return static_cast<COLOR>(bit_pos - 1);
+        const int side = static_cast<int>(face);
+        const uint64_t clr = 1 << static_cast<int>(color);
+        bitboard[side] = (bitboard[side] & ~(one_8 << (8 * idx))) | (clr << (8 * idx));
     }
 
     [[nodiscard]] bool isSolved() const override
@@ -222,10 +230,10 @@ public:
 
         this->rotateSide(0, 2, 3, 4, 2, 2, 3, 4);
         this->rotateSide(2, 2, 3, 4, 5, 2, 3, 4);
-        this->rotateSide(5, 2, 3, 4, 4, 7, 6, 0);
+        this->rotateSide(5, 2, 3, 4, 4, 6, 7, 0);
 
-        bitboard[4] = (bitboard[4] & ~(one_8 << (8 * 7))) | (clr1 << (8 * 7));
-        bitboard[4] = (bitboard[4] & ~(one_8 << (8 * 6))) | (clr2 << (8 * 6));
+        bitboard[4] = (bitboard[4] & ~(one_8 << (8 * 6))) | (clr1 << (8 * 6));
+        bitboard[4] = (bitboard[4] & ~(one_8 << (8 * 7))) | (clr2 << (8 * 7));
         bitboard[4] = (bitboard[4] & ~(one_8 << (8 * 0))) | (clr3 << (8 * 0));
 
         return *this;
@@ -316,27 +324,7 @@ public:
 
     bool operator==(const RubiksCubeBitboard& r1) const
     {
-        for (int i = 0; i < 6; i++)
-        {
-            if (bitboard[i] != r1.bitboard[i])
-            {
-                return false;
-            }
-        }
-        return true;
-    }
-
-    RubiksCubeBitboard& operator=(const RubiksCubeBitboard& r1)
-    {
-        if (this == &r1)
-        {
-            return *this;
-        }
-        for (int i = 0; i < 6; i++)
-        {
-            bitboard[i] = r1.bitboard[i];
-        }
-        return *this;
+        return ranges::equal(bitboard, r1.bitboard);
     }
 
     [[nodiscard]] uint64_t getCorners() const
@@ -0,0 +1,183 @@
+#include "ScrambleGenerator.h"
+#include "../PatternDatabases/PermutationIndexer.h"
+
+namespace
+{
+    constexpr size_t STATES_PER_CHUNK = 1 << 16;
+
+    uint64_t splitMix64(uint64_t& x)
+    {
+        uint64_t z = x += 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    template <size_t N>
+    bool isOddPermutation(const array<uint8_t, N>& perm)
+    {
+        bool odd = false;
+        for (size_t i = 0; i < N; ++i)
+        {
+            for (size_t j = i + 1; j < N; ++j)
+            {
+                odd ^= perm[i] > perm[j];
+            }
+        }
+        return odd;
+    }
+
+    // Faces come in axis pairs, L R, U D, F B, as 2 * axis and 2 * axis + 1. A face may not
+    // follow itself, and of two faces on one axis, which commute, only L R, U D, F B is kept.
+    bool canFollow(const int face, const int previousFace)
+    {
+        return previousFace < 0 || (face != previousFace && !(face / 2 == previousFace / 2 && face < previousFace));
+    }
+}
+
+ScrambleGenerator::ScrambleGenerator(const uint64_t seed, const uint64_t stream)
+{
+    // Mixing the stream into the seed first keeps nearby (seed, stream) pairs unrelated.
+    uint64_t x = seed;
+    x = splitMix64(x) ^ stream;
+    for (uint64_t& word : state)
+    {
+        word = splitMix64(x);
+    }
+}
+
+uint64_t ScrambleGenerator::randomSeed()
+{
+    random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+}
+
+uint64_t ScrambleGenerator::next()
+{
+    const uint64_t result = rotl(state[1] * 5, 7) * 9;
+    const uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    return result;
+}
+
+uint64_t ScrambleGenerator::nextBelow(const uint64_t bound)
+{
+    // Lemire's multiply and reject, which only divides on the rare rejection path.
+    unsigned __int128 product = static_cast<unsigned __int128>(next()) * bound;
+    if (static_cast<uint64_t>(product) < bound)
+    {
+        const uint64_t threshold = -bound % bound;
+        while (static_cast<uint64_t>(product) < threshold)
+        {
+            product = static_cast<unsigned __int128>(next()) * bound;
+        }
+    }
+    return product >> 64;
+}
+
+vector<RubiksCube::MOVE> ScrambleGenerator::randomMoves(const unsigned int length)
+{
+    // completions[k][face] counts the sequences of k moves that may follow a turn of face,
+    // scaled per k so long scrambles cannot overflow. Only ratios within a row are used.
+    vector<array<double, 6>> completions(max(1u, length));
+    completions[0].fill(1);
+    for (unsigned int k = 1; k < length; k++)
+    {
+        for (int previousFace = 0; previousFace < 6; previousFace++)
+        {
+            for (int face = 0; face < 6; face++)
+            {
+                if (canFollow(face, previousFace))
+                {
+                    completions[k][previousFace] += 3 * completions[k - 1][face];
+                }
+            }
+        }
+        const double scale = *ranges::max_element(completions[k]);
+        for (double& count : completions[k])
+        {
+            count /= scale;
+        }
+    }
+
+    vector<RubiksCube::MOVE> moves;
+    moves.reserve(length);
+    int previousFace = -1;
+    while (moves.size() < length)
+    {
+        // Each face is weighted by how many ways the scramble can still be finished after it,
+        // which makes every whole sequence equally likely, up to rounding of the weights.
+        const array<double, 6>& weights = completions[length - moves.size() - 1];
+        double total = 0;
+        for (int face = 0; face < 6; face++)
+        {
+            if (canFollow(face, previousFace)) total += weights[face];
+        }
+        double pick = static_cast<double>(next() >> 11) * 0x1.0p-53 * total;
+        int face = -1;
+        for (int candidate = 0; candidate < 6; candidate++)
+        {
+            if (!canFollow(candidate, previousFace)) continue;
+            face = candidate;
+            pick -= weights[candidate];
+            if (pick < 0) break;
+        }
+        moves.push_back(static_cast<RubiksCube::MOVE>(face * 3 + static_cast<int>(nextBelow(3))));
+        previousFace = face;
+    }
+    return moves;
+}
+
+PackedCube ScrambleGenerator::randomState()
+{
+    const uint64_t cornerRank = nextBelow(40320);
+    const uint64_t twists = nextBelow(2187);
+    const uint64_t flips = nextBelow(2048);
+    uint32_t edgeRank = static_cast<uint32_t>(nextBelow(479001600));
+    // A quarter turn is a 4-cycle of both corners and edges, so their permutations
+    // always have the same parity. Swapping the last two edges is a bijection between
+    // odd and even permutations, which keeps the fixed-up edge permutation uniform.
+    const bool cornersOdd = isOddPermutation(PermutationIndexer<8>::unrank(cornerRank));
+    array<uint8_t, 12> edgePerm = PermutationIndexer<12>::unrank(edgeRank);
+    if (isOddPermutation(edgePerm) != cornersOdd)
+    {
+        swap(edgePerm[10], edgePerm[11]);
+        edgeRank = PermutationIndexer<12>::rank(edgePerm);
+    }
+    return {cornerRank * 2187 + twists, edgeRank * 2048ull + flips};
+}
+
+vector<PackedCube> ScrambleGenerator::randomStates(const uint64_t seed, const size_t count, const unsigned int threads)
+{
+    vector<PackedCube> states(count);
+    const size_t numChunks = (count + STATES_PER_CHUNK - 1) / STATES_PER_CHUNK;
+    atomic<size_t> nextChunk = 0;
+    const auto work = [&]
+    {
+        for (size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+        {
+            ScrambleGenerator generator(seed, chunk);
+            const size_t end = min(count, (chunk + 1) * STATES_PER_CHUNK);
+            for (size_t i = chunk * STATES_PER_CHUNK; i < end; ++i)
+            {
+                states[i] = generator.randomState();
+            }
+        }
+    };
+    vector<thread> workers;
+    for (unsigned int t = 1; t < min<size_t>(max(1u, threads), numChunks); ++t)
+    {
+        workers.emplace_back(work);
+    }
+    work();
+    for (thread& worker : workers)
+    {
+        worker.join();
+    }
+    return states;
+}
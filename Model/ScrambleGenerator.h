@@ -0,0 +1,54 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "RubiksCube.h"
+#include "PackedCube.h"
+using namespace std;
+
+#ifndef SCRAMBLEGENERATOR_H
+#define SCRAMBLEGENERATOR_H
+
+/*
+ * Generates scrambles and random cube states from an explicit seed.
+ *
+ * Each generator owns a xoshiro256** state, so generators on different threads never
+ * share anything and the same (seed, stream) always gives the same output. Streams
+ * with the same seed are seeded independently, one stream per thread or per chunk
+ * of work keeps parallel generation reproducible.
+ */
+class ScrambleGenerator
+{
+    array<uint64_t, 4> state{};
+
+public:
+    explicit ScrambleGenerator(uint64_t seed, uint64_t stream = 0);
+
+    // A seed from the system's entropy source, for when reproducibility is not wanted.
+    [[nodiscard]] static uint64_t randomSeed();
+
+    [[nodiscard]] uint64_t next();
+
+    // Uniform in [0, bound), bound must be positive.
+    [[nodiscard]] uint64_t nextBelow(uint64_t bound);
+
+    /*
+     * A scramble of length moves without redundant pairs: no two consecutive moves turn
+     * the same face, and two consecutive moves on opposite faces, which commute, only
+     * come in L R, U D, F B order. Every such sequence is equally likely.
+     */
+    vector<RubiksCube::MOVE> randomMoves(unsigned int length);
+
+    /*
+     * A state drawn uniformly from the reachable states: random corner and edge
+     * permutations of equal parity, with any twists and flips that sum to zero.
+     */
+    PackedCube randomState();
+
+    /*
+     * Fills count uniformly random reachable states split across threads. The states
+     * are generated in fixed chunks of one stream each, so the output depends only on
+     * the seed and count, not on the number of threads.
+     */
+    static vector<PackedCube> randomStates(uint64_t seed, size_t count, unsigned int threads);
+};
+
+#endif //SCRAMBLEGENERATOR_H
@@ -0,0 +1,252 @@
+#pragma once
+#include "bits/stdc++.h"
+#include "../Model/RubiksCube.h"
+#include "NibbleArray.h"
+#include "DatabaseFile.h"
+
+#ifndef BASICPATTERNDATABASE_H
+#define BASICPATTERNDATABASE_H
+
+/*
+ * A pattern database whose index function and storage are fixed at compile time,
+ * so a lookup from a search loop compiles down to the index arithmetic and a load.
+ *
+ * Indexer provides KIND, the DATABASE_KIND written to files, and may provide SIZE,
+ * the number of entries, and a static getIndex(const Cube&) for any cube type.
+ * Tables without getIndex are indexed by the caller, like PatternDatabase's.
+ *
+ * Storage is constructed from (size, value, placement) and provides get, set,
+ * prefetch, data, storageSize, getBacking, inflate and reset, as NibbleArray does.
+ */
+template <typename Indexer, typename Storage = NibbleArray>
+class BasicPatternDatabase
+{
+    Storage database;
+    size_t size;
+    size_t numItems;
+    uint8_t initValue;
+    uint8_t depthLimit;
+    uint8_t unsetBound;
+
+public:
+    explicit BasicPatternDatabase(const size_t size = Indexer::SIZE, const uint8_t init_val = 0xFF,
+                                  const StoragePlacement placement = {}) :
+        database(size, init_val, placement), size(size), numItems(0), initValue(init_val), depthLimit(0xF),
+        unsetBound(0xF)
+    {
+    }
+
+    template <typename Cube> requires derived_from<Cube, RubiksCube>
+    [[nodiscard]] static uint32_t getDatabaseIndex(const Cube& cube)
+    {
+        return Indexer::getIndex(cube);
+    }
+
+    bool setNumMoves(const uint32_t ind, const uint8_t numMoves)
+    {
+        const uint8_t oldMoves = this->getNumMoves(ind);
+        if (oldMoves == 0xF)
+        {
+            ++this->numItems;
+        }
+        if (oldMoves > numMoves)
+        {
+            this->database.set(ind, numMoves);
+            return true;
+        }
+        return false;
+    }
+
+    template <typename Cube> requires derived_from<Cube, RubiksCube>
+    bool setNumMoves(const Cube& cube, const uint8_t numMoves)
+    {
+        return this->setNumMoves(getDatabaseIndex(cube), numMoves);
+    }
+
+    [[nodiscard]] uint8_t getNumMoves(const uint32_t ind) const
+    {
+        return this->database.get(ind);
+    }
+
+    template <typename Cube> requires derived_from<Cube, RubiksCube>
+    [[nodiscard]] uint8_t getNumMoves(const Cube& cube) const
+    {
+        return this->getNumMoves(getDatabaseIndex(cube));
+    }
+
+    // Prefetches all n entries before reading any of them, so the cache misses overlap.
+    void getNumMovesBatch(const uint32_t* ind, uint8_t* out, const size_t n) const
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            this->database.prefetch(ind[i]);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            out[i] = this->database.get(ind[i]);
+        }
+    }
+
+    [[nodiscard]] size_t getSize() const
+    {
+        return this->size;
+    }
+
+    [[nodiscard]] size_t getNumItems() const
+    {
+        return this->numItems;
+    }
+
+    [[nodiscard]] bool isFull() const
+    {
+        return this->numItems == this->size;
+    }
+
+    [[nodiscard]] static DATABASE_KIND getKind()
+    {
+        return Indexer::KIND;
+    }
+
+    // The largest stored number of moves, ignoring unset (0xF) entries.
+    [[nodiscard]] uint8_t getMaxDepth() const
+    {
+        uint8_t maxDepth = 0;
+        for (size_t i = 0; i < this->size; ++i)
+        {
+            if (const uint8_t numMoves = this->database.get(i); numMoves != 0xF)
+            {
+                maxDepth = max(maxDepth, numMoves);
+            }
+        }
+        return maxDepth;
+    }
+
+    [[nodiscard]] uint8_t getDepthLimit() const
+    {
+        return this->depthLimit;
+    }
+
+    // Records the depth the generator stopped at, so it is kept in the file header.
+    void setDepthLimit(const uint8_t limit)
+    {
+        this->depthLimit = limit;
+        this->unsetBound = limit < 0xF ? limit + 1 : 0xF;
+    }
+
+    /*
+     * The most an unset (0xF) entry can be relied on for: the state is further than the
+     * generator went, so at least one past its depth limit, or past the deepest stored
+     * entry when the file does not record the limit. Searches must clamp entries to this,
+     * a raw 0xF overestimates and makes the heuristic inadmissible.
+     */
+    [[nodiscard]] uint8_t getUnsetBound() const
+    {
+        return this->unsetBound;
+    }
+
+    // Describes the memory backing the table, eg- "hugetlb" or "thp+numa-interleave".
+    [[nodiscard]] string getStorageBacking() const
+    {
+        return this->database.getBacking();
+    }
+
+    void toFile(const string& filePath, const DATABASE_KIND kind = Indexer::KIND) const
+    {
+        DatabaseFileHeader header{};
+        header.kind = kind;
+        header.encoding = DATABASE_ENCODING::NIBBLE;
+        header.maxDepth = this->getMaxDepth();
+        header.numEntries = this->size;
+        header.numItems = this->numItems;
+        header.depthLimit = this->depthLimit;
+        header.initValue = this->initValue;
+        writeDatabaseFile(filePath, header, this->database.data(), this->database.storageSize());
+    }
+
+    bool fromFile(const string& filePath, const VERIFY_MODE mode = VERIFY_MODE::DEFAULT,
+                  const DATABASE_KIND kind = Indexer::KIND)
+    {
+        ifstream reader(filePath, ios::in | ios::binary | ios::ate);
+        if (!reader.is_open())
+        {
+            return false;
+        }
+        const size_t fileSize = reader.tellg();
+        reader.seekg(0, ios::beg);
+        const optional<DatabaseFileHeader> header = readDatabaseHeader(reader, fileSize);
+        if (!header)
+        {
+            // Legacy files are the raw nibble bytes with nothing to verify them against.
+            if (mode == VERIFY_MODE::STRICT)
+            {
+                reader.close();
+                throw runtime_error("Database has no header! Refusing to load it in strict mode");
+            }
+            if (fileSize != this->database.storageSize())
+            {
+                reader.close();
+                throw runtime_error("Database corrupt! Failed to open Reader");
+            }
+            reader.read(
+                reinterpret_cast<char*>(this->database.data()),
+                this->database.storageSize()
+            );
+            reader.close();
+            this->numItems = this->size;
+            // Nothing records how far the generator went, one scan finds the deepest entry instead.
+            this->unsetBound = static_cast<uint8_t>(min(this->getMaxDepth() + 1, 0xF));
+            return true;
+        }
+        if (header->kind != kind || header->encoding != DATABASE_ENCODING::NIBBLE ||
+            header->numEntries != this->size || header->payloadSize != this->database.storageSize())
+        {
+            reader.close();
+            throw runtime_error("Database header does not match this pattern database");
+        }
+        readDatabasePayload(reader, *header, this->database.data(), mode);
+        reader.close();
+        this->numItems = header->numItems;
+        this->initValue = header->initValue;
+        this->setDepthLimit(header->depthLimit);
+        if (this->depthLimit == 0xF)
+        {
+            this->unsetBound = min<uint8_t>(header->maxDepth + 1, 0xF);
+        }
+        return true;
+    }
+
+    // Raw nibble bytes of the table, eg- for generator checkpoints.
+    [[nodiscard]] const uint8_t* data() const
+    {
+        return this->database.data();
+    }
+
+    [[nodiscard]] size_t storageSize() const
+    {
+        return this->database.storageSize();
+    }
+
+    void fromData(const uint8_t* data, const size_t numItems)
+    {
+        memcpy(this->database.data(), data, this->database.storageSize());
+        this->numItems = numItems;
+    }
+
+    [[nodiscard]] vector<uint8_t> inflate() const
+    {
+        vector<uint8_t> inflated;
+        this->database.inflate(inflated);
+        return inflated;
+    }
+
+    void reset()
+    {
+        if (this->numItems != 0)
+        {
+            this->database.reset(0xFF);
+            this->numItems = 0;
+        }
+    }
+};
+
+#endif //BASICPATTERNDATABASE_H
@@ -0,0 +1,76 @@
+#include "ConcurrentNibbleArray.h"
+using namespace std;
+
+namespace
+{
+    // Byte pos / 2 holds the entry in its high nibble when pos is even, as in NibbleArray.
+    unsigned getShift(const size_t pos)
+    {
+        return ((pos % 16) / 2) * 8 + (pos % 2 ? 0 : 4);
+    }
+}
+
+ConcurrentNibbleArray::ConcurrentNibbleArray(const size_t size, const uint8_t val, const StoragePlacement placement) :
+    size(size), words(((size / 2 + 1) + 7) / 8 * 8, val, placement)
+{
+    static_assert(endian::native == endian::little);
+}
+
+atomic_ref<uint64_t> ConcurrentNibbleArray::getWord(const size_t pos) const
+{
+    assert(pos <= this->size);
+    auto* word = reinterpret_cast<uint64_t*>(const_cast<uint8_t*>(this->words.data())) + pos / 16;
+    return atomic_ref<uint64_t>(*word);
+}
+
+uint8_t ConcurrentNibbleArray::get(const size_t pos) const
+{
+    return (this->getWord(pos).load(memory_order_relaxed) >> getShift(pos)) & 0x0F;
+}
+
+void ConcurrentNibbleArray::set(const size_t pos, const uint8_t val)
+{
+    const atomic_ref<uint64_t> word = this->getWord(pos);
+    const unsigned shift = getShift(pos);
+    uint64_t expected = word.load(memory_order_relaxed);
+    uint64_t desired;
+    do
+    {
+        desired = (expected & ~(0x0Full << shift)) | (static_cast<uint64_t>(val & 0x0F) << shift);
+    }
+    while (!word.compare_exchange_weak(expected, desired, memory_order_relaxed));
+}
+
+bool ConcurrentNibbleArray::setIfSmaller(const size_t pos, const uint8_t val)
+{
+    const atomic_ref<uint64_t> word = this->getWord(pos);
+    const unsigned shift = getShift(pos);
+    uint64_t expected = word.load(memory_order_relaxed);
+    while (true)
+    {
+        if (((expected >> shift) & 0x0F) <= val)
+        {
+            return false;
+        }
+        const uint64_t desired = (expected & ~(0x0Full << shift)) | (static_cast<uint64_t>(val & 0x0F) << shift);
+        if (word.compare_exchange_weak(expected, desired, memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+}
+
+const uint8_t* ConcurrentNibbleArray::data() const
+{
+    return this->words.data();
+}
+
+size_t ConcurrentNibbleArray::storageSize() const
+{
+    return this->size / 2 + 1;
+}
+
+void ConcurrentNibbleArray::reset(const uint8_t val)
+{
+    memset(this->words.data(), val, this->words.size());
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <bits/stdc++.h>
+#include "StorageBuffer.h"
+using namespace std;
+
+#ifndef CONCURRENTNIBBLEARRAY_H
+#define CONCURRENTNIBBLEARRAY_H
+
+// A NibbleArray that several threads can update at once. Entries are packed
+// sixteen to a 64-bit word and every write is a compare-and-swap on that word,
+// so neighbouring entries never clobber each other. On little-endian hosts the
+// bytes are laid out exactly like NibbleArray, so data() can be written out as is.
+class ConcurrentNibbleArray
+{
+    size_t size;
+    StorageBuffer words;
+
+    [[nodiscard]] atomic_ref<uint64_t> getWord(size_t pos) const;
+
+public:
+    explicit ConcurrentNibbleArray(size_t size, uint8_t val = 0xFF, StoragePlacement placement = {});
+
+    // Relaxed read, it may miss a write made concurrently by another thread.
+    [[nodiscard]] uint8_t get(size_t pos) const;
+
+    void set(size_t pos, uint8_t val);
+
+    // Lowers the entry to val if val is smaller, returns true if this call changed it.
+    bool setIfSmaller(size_t pos, uint8_t val);
+
+    [[nodiscard]] const uint8_t* data() const;
+
+    // Same as NibbleArray::storageSize, the padding up to a whole word is not counted.
+    [[nodiscard]] size_t storageSize() const;
+
+    // Not safe to call while other threads are writing.
+    void reset(uint8_t val = 0xFF);
+};
+
+#endif //CONCURRENTNIBBLEARRAY_H
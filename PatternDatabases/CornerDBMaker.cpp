@@ -12,35 +12,168 @@ CornerDBMaker::CornerDBMaker(const string& _fileName, const uint8_t init_val)
     cornerDB = CornerPatternDatabase(init_val);
 }
 
+void CornerDBMaker::setCheckpoint(const string& _checkpointFileName, const chrono::seconds interval)
+{
+    checkpointFileName = _checkpointFileName;
+    checkpointInterval = interval;
+}
+
+/*
+ * The checkpoint payload is the BFS position followed by the table:
+ *
+ *   uint32 depth, uint32 padding, uint64 nodes left in the level, uint64 queue size,
+ *   PackedCube per queued cube, nibble table
+ *
+ * It is written to a temporary file and renamed into place, and the previous
+ * checkpoint is kept as a fallback, so a crash mid-write never loses both.
+ */
+void CornerDBMaker::writeCheckpoint(const deque<PackedCube>& q, const int curr_depth,
+                                    const size_t remaining) const
+{
+    constexpr size_t cubeSize = sizeof(PackedCube);
+    vector<uint8_t> payload(24 + q.size() * cubeSize + cornerDB.storageSize());
+    const uint32_t depth = curr_depth;
+    const uint64_t numLeft = remaining, numQueued = q.size();
+    memcpy(payload.data(), &depth, sizeof(depth));
+    memcpy(payload.data() + 8, &numLeft, sizeof(numLeft));
+    memcpy(payload.data() + 16, &numQueued, sizeof(numQueued));
+    uint8_t* out = payload.data() + 24;
+    for (const PackedCube& node : q)
+    {
+        memcpy(out, &node, cubeSize);
+        out += cubeSize;
+    }
+    memcpy(out, cornerDB.data(), cornerDB.storageSize());
+
+    DatabaseFileHeader header{};
+    header.kind = DATABASE_KIND::CORNER_CHECKPOINT;
+    header.encoding = DATABASE_ENCODING::NIBBLE;
+    header.maxDepth = curr_depth;
+    header.numEntries = cornerDB.getSize();
+    header.numItems = cornerDB.getNumItems();
+    header.depthLimit = cornerDB.getDepthLimit();
+    const string tempFileName = checkpointFileName + ".tmp";
+    writeDatabaseFile(tempFileName, header, payload.data(), payload.size());
+    if (filesystem::exists(checkpointFileName))
+    {
+        filesystem::rename(checkpointFileName, checkpointFileName + ".prev");
+    }
+    filesystem::rename(tempFileName, checkpointFileName);
+}
+
+bool CornerDBMaker::readCheckpoint(const string& filePath, deque<PackedCube>& q, int& curr_depth,
+                                   size_t& remaining)
+{
+    ifstream reader(filePath, ios::in | ios::binary | ios::ate);
+    if (!reader.is_open())
+    {
+        return false;
+    }
+    const size_t fileSize = reader.tellg();
+    reader.seekg(0, ios::beg);
+    const optional<DatabaseFileHeader> header = readDatabaseHeader(reader, fileSize);
+    if (!header || header->kind != DATABASE_KIND::CORNER_CHECKPOINT || header->numEntries != cornerDB.getSize())
+    {
+        return false;
+    }
+    vector<uint8_t> payload(header->payloadSize);
+    readDatabasePayload(reader, *header, payload.data(), VERIFY_MODE::STRICT);
+
+    constexpr size_t cubeSize = sizeof(PackedCube);
+    uint32_t depth;
+    uint64_t numLeft, numQueued;
+    memcpy(&depth, payload.data(), sizeof(depth));
+    memcpy(&numLeft, payload.data() + 8, sizeof(numLeft));
+    memcpy(&numQueued, payload.data() + 16, sizeof(numQueued));
+    if (payload.size() != 24 + numQueued * cubeSize + cornerDB.storageSize())
+    {
+        return false;
+    }
+    q.clear();
+    const uint8_t* in = payload.data() + 24;
+    for (uint64_t i = 0; i < numQueued; i++)
+    {
+        PackedCube node{};
+        memcpy(&node, in, cubeSize);
+        q.push_back(node);
+        in += cubeSize;
+    }
+    cornerDB.fromData(in, header->numItems);
+    curr_depth = static_cast<int>(depth);
+    remaining = numLeft;
+    return true;
+}
+
 bool CornerDBMaker::bfsAndStore()
 {
     const RubiksCubeBitboard cube;
-    queue<RubiksCubeBitboard> q;
-    q.push(cube);
-    cornerDB.setNumMoves(cube, 0);
+    deque<PackedCube> q;
     int curr_depth = 0;
+    size_t remaining = 0;
+    bool resumed = false;
+    if (!checkpointFileName.empty())
+    {
+        // Resume from the latest checkpoint that verifies, falling back to the one before it.
+        for (const string& filePath : {checkpointFileName, checkpointFileName + ".prev"})
+        {
+            try
+            {
+                resumed = readCheckpoint(filePath, q, curr_depth, remaining);
+            }
+            catch (const exception&)
+            {
+                resumed = false;
+            }
+            if (resumed) break;
+        }
+    }
+    if (!resumed)
+    {
+        q.push_back(PackedCube::pack(cube));
+        cornerDB.setNumMoves(cube, 0);
+    }
+    auto last_checkpoint = chrono::steady_clock::now();
+    uint64_t nodes_since_check = 0;
     while (!q.empty())
     {
-        const unsigned n = q.size();
-        curr_depth++;
-        if (curr_depth == 9) break;
-        for (int counter = 0; counter < n; counter++)
+        if (remaining == 0)
+        {
+            curr_depth++;
+            if (curr_depth == 9) break;
+            remaining = q.size();
+        }
+        RubiksCubeBitboard node;
+        q.front().unpack(node);
+        q.pop_front();
+        remaining--;
+        for (int i = 0; i < 18; i++)
+        {
+            const auto curr_move = static_cast<RubiksCube::MOVE>(i);
+            node.move(curr_move);
+            if (static_cast<int>(cornerDB.getNumMoves(node)) > curr_depth)
+            {
+                cornerDB.setNumMoves(node, curr_depth);
+                q.push_back(PackedCube::pack(node));
+            }
+            node.invert(curr_move);
+        }
+        // Reading the clock for every node would cost more than the node itself.
+        if (!checkpointFileName.empty() && ++nodes_since_check == 4096)
         {
-            RubiksCubeBitboard node = q.front();
-            q.pop();
-            for (int i = 0; i < 18; i++)
+            nodes_since_check = 0;
+            if (chrono::steady_clock::now() - last_checkpoint >= checkpointInterval)
             {
-                const auto curr_move = static_cast<RubiksCube::MOVE>(i);
-                node.move(curr_move);
-                if (static_cast<int>(cornerDB.getNumMoves(node)) > curr_depth)
-                {
-                    cornerDB.setNumMoves(node, curr_depth);
-                    q.push(node);
-                }
-                node.invert(curr_move);
+                writeCheckpoint(q, curr_depth, remaining);
+                last_checkpoint = chrono::steady_clock::now();
             }
         }
     }
+    cornerDB.setDepthLimit(curr_depth - 1);
     cornerDB.toFile(fileName);
+    if (!checkpointFileName.empty())
+    {
+        filesystem::remove(checkpointFileName);
+        filesystem::remove(checkpointFileName + ".prev");
+    }
     return true;
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "CornerPatternDatabase.h"
 #include "../Model/RubiksCubeBitboard.cpp"
+#include "../Model/PackedCube.h"
 
 #ifndef CORNERDBMAKER_H
 #define CORNERDBMAKER_H
@@ -9,10 +10,17 @@ class CornerDBMaker
 {
     string fileName;
     CornerPatternDatabase cornerDB;
+    string checkpointFileName;
+    chrono::seconds checkpointInterval{0};
+
+    void writeCheckpoint(const deque<PackedCube>& q, int curr_depth, size_t remaining) const;
+    bool readCheckpoint(const string& filePath, deque<PackedCube>& q, int& curr_depth, size_t& remaining);
 
 public:
     explicit CornerDBMaker(const string& _fileName);
     CornerDBMaker(const string& _fileName, uint8_t init_val);
+    // Snapshots the search to _checkpointFileName every interval and resumes from it on the next run.
+    void setCheckpoint(const string& _checkpointFileName, chrono::seconds interval = chrono::minutes(5));
     bool bfsAndStore();
 };
 
@@ -1,43 +1,14 @@
 #include "CornerPatternDatabase.h"
 
-CornerPatternDatabase::CornerPatternDatabase() : PatternDatabase(100179840)
+CornerPatternDatabase::CornerPatternDatabase() : BasicPatternDatabase(TABLE_SIZE)
 {
 }
 
-CornerPatternDatabase::CornerPatternDatabase(const uint8_t init_val) : PatternDatabase(100179840, init_val)
+CornerPatternDatabase::CornerPatternDatabase(const uint8_t init_val) : BasicPatternDatabase(TABLE_SIZE, init_val)
 {
 }
 
-uint32_t CornerPatternDatabase::getDatabaseIndex(const RubiksCube& cube) const
+CornerPatternDatabase::CornerPatternDatabase(const StoragePlacement placement, const uint8_t init_val) :
+    BasicPatternDatabase(TABLE_SIZE, init_val, placement)
 {
-    const array cornerPerm =
-    {
-        cube.getCornerIndex(0),
-        cube.getCornerIndex(1),
-        cube.getCornerIndex(2),
-        cube.getCornerIndex(3),
-        cube.getCornerIndex(4),
-        cube.getCornerIndex(5),
-        cube.getCornerIndex(6),
-        cube.getCornerIndex(7),
-    };
-    const unsigned int rank = this->permIndexer.rank(cornerPerm);
-    const array cornerOrientations = {
-        cube.getCornerOrientation(0),
-        cube.getCornerOrientation(1),
-        cube.getCornerOrientation(2),
-        cube.getCornerOrientation(3),
-        cube.getCornerOrientation(4),
-        cube.getCornerOrientation(5),
-        cube.getCornerOrientation(6),
-    };
-    const uint32_t orientationNum =
-        cornerOrientations[0] * 729 +
-        cornerOrientations[1] * 243 +
-        cornerOrientations[2] * 81 +
-        cornerOrientations[3] * 27 +
-        cornerOrientations[4] * 9 +
-        cornerOrientations[5] * 3 +
-        cornerOrientations[6];
-    return (rank * 2187) + orientationNum;
 }
@@ -1,23 +1,124 @@
 #pragma once
 #include "../Model/RubiksCube.h"
-#include "PatternDatabase.h"
+#include "../Model/CubeGeometry.h"
+#include "BasicPatternDatabase.h"
 #include "PermutationIndexer.h"
 
 #ifndef CORNERPATTERNDATABASE_H
 #define CORNERPATTERNDATABASE_H
 
-class CornerPatternDatabase : public PatternDatabase
+// Indexes a cube by its corners: the rank of their permutation * 3^7 + the first 7 twists.
+struct CornerIndexer
 {
-    typedef RubiksCube::FACE F;
-    PermutationIndexer<8> permIndexer;
+    // Corner states, 8! permutations * 3^7 twists. The table is allocated a little larger,
+    // entries from NUM_STATES to SIZE are never indexed.
+    static constexpr uint32_t NUM_STATES = 40320 * 2187;
+    static constexpr uint32_t SIZE = 100179840;
+    static constexpr DATABASE_KIND KIND = DATABASE_KIND::CORNER;
+
+private:
+    // A corner is numbered by its yellow, orange and green stickers, as in RubiksCube::getCornerIndex.
+    // Indexed by COLOR: WHITE, GREEN, RED, BLUE, ORANGE, YELLOW, padded to 8 so a masked color stays in range.
+    static constexpr uint8_t COLOR_BITS[8] = {0, 1, 0, 0, 2, 4, 0, 0};
+
+    // Corners are numbered by their yellow, orange and green stickers, which puts the
+    // corners at home in positions 2 and 3 the other way round.
+    static constexpr uint8_t CORNER_HOMES[8] = {0, 1, 3, 2, 4, 5, 6, 7};
+
+    /*
+     * Reads the corner at each position and its twist, the sticker its white or yellow
+     * face is on. This is RubiksCube::getCornerIndex and getCornerOrientation without
+     * the strings, and through the cube's own type, so a final cube's getColor inlines.
+     */
+    template <typename Cube>
+    static void readCorners(const Cube& cube, array<uint8_t, 8>& cornerPerm, array<uint8_t, 8>& cornerOrientations)
+    {
+        for (uint8_t position = 0; position < 8; ++position)
+        {
+            uint8_t corner = 0, twist = 0;
+            for (uint8_t k = 0; k < 3; ++k)
+            {
+                const Facelet& facelet = CORNER_FACELETS[position][k];
+                const RubiksCube::COLOR color = cube.getColor(facelet.face, facelet.row, facelet.col);
+                corner |= COLOR_BITS[static_cast<unsigned>(color) & 7];
+                if (color == RubiksCube::COLOR::WHITE || color == RubiksCube::COLOR::YELLOW)
+                {
+                    twist = k;
+                }
+            }
+            cornerPerm[position] = corner;
+            cornerOrientations[position] = twist;
+        }
+    }
+
+    // The index of the corners in cornerPerm with the first 7 twists in cornerOrientations,
+    // the last twist follows from the others.
+    static uint32_t toIndex(const array<uint8_t, 8>& cornerPerm, const uint8_t* cornerOrientations)
+    {
+        const unsigned int rank = PermutationIndexer<8>::rank(cornerPerm);
+        const uint32_t orientationNum =
+            cornerOrientations[0] * 729 +
+            cornerOrientations[1] * 243 +
+            cornerOrientations[2] * 81 +
+            cornerOrientations[3] * 27 +
+            cornerOrientations[4] * 9 +
+            cornerOrientations[5] * 3 +
+            cornerOrientations[6];
+        return (rank * 2187) + orientationNum;
+    }
 
 public:
+    template <typename Cube>
+    static uint32_t getIndex(const Cube& cube)
+    {
+        array<uint8_t, 8> cornerPerm{}, cornerOrientations{};
+        readCorners(cube, cornerPerm, cornerOrientations);
+        return toIndex(cornerPerm, cornerOrientations.data());
+    }
+
+    template <typename Cube>
+    static pair<uint32_t, uint32_t> getIndexAndDual(const Cube& cube)
+    {
+        array<uint8_t, 8> cornerPerm{}, cornerOrientations{};
+        array<uint8_t, 8> dualPerm{}, dualOrientations{};
+        readCorners(cube, cornerPerm, cornerOrientations);
+        // The corner at position goes back home in the inverse, and the corner from its home
+        // lands at position. The twist is undone, and an orientation counted in opposite
+        // directions at the two positions reads the same.
+        for (uint8_t position = 0; position < 8; ++position)
+        {
+            const uint8_t home = CORNER_HOMES[cornerPerm[position]];
+            dualPerm[home] = CORNER_HOMES[position];
+            const uint8_t orientation = cornerOrientations[position];
+            dualOrientations[home] = CORNER_CLOCKWISE[position] == CORNER_CLOCKWISE[home]
+                                         ? (3 - orientation) % 3
+                                         : orientation;
+        }
+        return {toIndex(cornerPerm, cornerOrientations.data()), toIndex(dualPerm, dualOrientations.data())};
+    }
+};
+
+// The corner table searches use. Nothing in it is virtual, a lookup inlines into the search.
+class CornerPatternDatabase : public BasicPatternDatabase<CornerIndexer>
+{
+public:
+    static constexpr uint32_t NUM_STATES = CornerIndexer::NUM_STATES;
+    static constexpr uint32_t TABLE_SIZE = CornerIndexer::SIZE;
+
     CornerPatternDatabase();
     // Use explicit when you want to keep your type conversions under tight control and avoid
     // any "magic" conversions that might happen without your clear intent.
     explicit CornerPatternDatabase(uint8_t init_val);
-    // If you try to ignore the return value, many modern compilers will generate a warning.
-    [[nodiscard]] uint32_t getDatabaseIndex(const RubiksCube& cube) const override;
+    explicit CornerPatternDatabase(StoragePlacement placement, uint8_t init_val = 0xFF);
+
+    // Returns the index of the cube and of its inverse, the state reached by undoing the
+    // cube's moves from solved. Both are the same distance from solved, so the larger of
+    // the two entries is still a lower bound.
+    template <typename Cube> requires derived_from<Cube, RubiksCube>
+    [[nodiscard]] static pair<uint32_t, uint32_t> getDatabaseIndexAndDual(const Cube& cube)
+    {
+        return CornerIndexer::getIndexAndDual(cube);
+    }
 };
 
 #endif //CORNERPATTERNDATABASE_H
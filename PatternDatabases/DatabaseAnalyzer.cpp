@@ -0,0 +1,228 @@
+#include "DatabaseAnalyzer.h"
+#include "CornerPatternDatabase.h"
+#include "../Model/RubiksCubeBitboard.cpp"
+#include "../Model/ScrambleGenerator.h"
+using namespace std;
+
+namespace
+{
+    // Below this many entries per thread the threads would cost more than they count.
+    constexpr size_t MIN_ENTRIES_PER_THREAD = 1 << 20;
+
+    string getKindName(const DATABASE_KIND kind)
+    {
+        switch (kind)
+        {
+        case DATABASE_KIND::GENERIC: return "generic";
+        case DATABASE_KIND::CORNER: return "corner";
+        case DATABASE_KIND::PERIMETER: return "perimeter";
+        case DATABASE_KIND::CORNER_CHECKPOINT: return "corner-checkpoint";
+        case DATABASE_KIND::POCKET_CUBE: return "pocket-cube";
+        default: return "?";
+        }
+    }
+
+    uint8_t getNibble(const uint8_t* data, const size_t pos)
+    {
+        return pos % 2 != 0 ? data[pos / 2] & 0x0F : data[pos / 2] >> 4;
+    }
+
+    // Samples random states on every thread, each with a stream of its own, and checks their neighbours.
+    void checkConsistency(const uint8_t* data, const unsigned int threads, const uint64_t seed, DatabaseReport& report)
+    {
+        atomic<uint64_t> pairsChecked = 0, violations = 0;
+        const auto work = [&](const unsigned int t)
+        {
+            ScrambleGenerator generator(seed, t);
+            RubiksCubeBitboard cube;
+            uint64_t checked = 0, failed = 0;
+            const uint64_t count = report.samples * (t + 1) / threads - report.samples * t / threads;
+            for (uint64_t i = 0; i < count; i++)
+            {
+                generator.randomState().unpack(cube);
+                const uint8_t value = getNibble(data, CornerPatternDatabase::getDatabaseIndex(cube));
+                for (int m = 0; m < 18; m++)
+                {
+                    const auto move = static_cast<RubiksCube::MOVE>(m);
+                    cube.move(move);
+                    const uint8_t childValue = getNibble(data, CornerPatternDatabase::getDatabaseIndex(cube));
+                    cube.invert(move);
+                    // An unset entry is only known to be past the depth limit, which is
+                    // too far from a set value below the limit.
+                    const bool parentSet = value != 0xF, childSet = childValue != 0xF;
+                    if (parentSet && childSet)
+                    {
+                        ++checked;
+                        failed += abs(value - childValue) > 1;
+                    }
+                    else if (parentSet != childSet && report.depthLimit != 0xF)
+                    {
+                        ++checked;
+                        failed += min(value, childValue) < report.depthLimit;
+                    }
+                }
+            }
+            pairsChecked += checked;
+            violations += failed;
+        };
+        vector<thread> workers;
+        for (unsigned int t = 1; t < threads; t++)
+        {
+            workers.emplace_back(work, t);
+        }
+        work(0);
+        for (thread& worker : workers)
+        {
+            worker.join();
+        }
+        report.pairsChecked = pairsChecked;
+        report.violations = violations;
+    }
+}
+
+array<uint64_t, 16> countNibbleValues(const uint8_t* data, const size_t numEntries, const unsigned int threads)
+{
+    // Each thread counts whole bytes, so no byte is split between two threads.
+    const size_t numBytes = numEntries / 2;
+    const size_t numThreads = clamp<size_t>(numEntries / MIN_ENTRIES_PER_THREAD, 1, max(1u, threads));
+    vector<array<uint64_t, 16>> partial(numThreads);
+    const auto work = [&](const size_t t)
+    {
+        array<uint64_t, 16>& counts = partial[t];
+        for (size_t i = numBytes * t / numThreads; i < numBytes * (t + 1) / numThreads; i++)
+        {
+            ++counts[data[i] & 0x0F];
+            ++counts[data[i] >> 4];
+        }
+    };
+    vector<thread> workers;
+    for (size_t t = 1; t < numThreads; t++)
+    {
+        workers.emplace_back(work, t);
+    }
+    work(0);
+    for (thread& worker : workers)
+    {
+        worker.join();
+    }
+    array<uint64_t, 16> counts{};
+    for (const array<uint64_t, 16>& part : partial)
+    {
+        for (size_t v = 0; v < 16; v++)
+        {
+            counts[v] += part[v];
+        }
+    }
+    if (numEntries % 2 != 0)
+    {
+        ++counts[data[numBytes] >> 4];
+    }
+    return counts;
+}
+
+DatabaseReport analyzeDatabase(const string& filePath, const unsigned int threads, const uint64_t samples,
+                               const uint64_t seed)
+{
+    const MappedDatabaseFile file(filePath);
+    DatabaseReport report;
+    const optional<DatabaseFileHeader>& header = file.getHeader();
+    if (header)
+    {
+        if (header->encoding != DATABASE_ENCODING::NIBBLE)
+        {
+            throw runtime_error(filePath + " is a " + getKindName(header->kind) + " database, not a nibble table");
+        }
+        report.kind = header->kind;
+        report.numEntries = header->numEntries;
+        report.depthLimit = header->depthLimit;
+    }
+    else
+    {
+        // Legacy files carry nothing but the nibbles, a corner table is recognised by its size.
+        report.kind = file.getPayloadSize() == CornerPatternDatabase::TABLE_SIZE / 2 + 1
+                          ? DATABASE_KIND::CORNER
+                          : DATABASE_KIND::GENERIC;
+        report.numEntries = (file.getPayloadSize() - 1) * 2;
+    }
+    if (report.kind == DATABASE_KIND::CORNER)
+    {
+        report.numEntries = min<uint64_t>(report.numEntries, CornerPatternDatabase::NUM_STATES);
+    }
+
+    report.histogram = countNibbleValues(file.getPayload(), report.numEntries, threads);
+    uint64_t numSet = 0, sum = 0;
+    for (uint8_t v = 0; v < 0xF; v++)
+    {
+        if (report.histogram[v] > 0)
+        {
+            report.maxValue = v;
+        }
+        numSet += report.histogram[v];
+        sum += static_cast<uint64_t>(v) * report.histogram[v];
+    }
+    report.meanValue = numSet > 0 ? static_cast<double>(sum) / static_cast<double>(numSet) : 0;
+    report.meanLowerBound = report.meanValue;
+    if (report.depthLimit != 0xF && report.numEntries > 0)
+    {
+        report.meanLowerBound = static_cast<double>(sum + report.histogram[0xF] * (report.depthLimit + 1)) /
+            static_cast<double>(report.numEntries);
+    }
+
+    if (report.kind == DATABASE_KIND::CORNER && samples > 0)
+    {
+        report.samples = samples;
+        checkConsistency(file.getPayload(), max(1u, threads), seed, report);
+    }
+    return report;
+}
+
+void printDatabaseReport(ostream& out, const DatabaseReport& report)
+{
+    const auto percent = [&](const uint64_t count)
+    {
+        return report.numEntries > 0 ? 100.0 * static_cast<double>(count) / static_cast<double>(report.numEntries) : 0;
+    };
+    out << fixed << setprecision(3)
+        << "kind:          " << getKindName(report.kind) << "\n"
+        << "entries:       " << report.numEntries << "\n"
+        << "depth limit:   " << (report.depthLimit == 0xF ? "unknown" : to_string(report.depthLimit)) << "\n";
+    for (uint8_t v = 0; v < 0xF; v++)
+    {
+        if (report.histogram[v] > 0)
+        {
+            out << "  " << setw(2) << static_cast<int>(v) << " moves:    " << setw(12) << report.histogram[v]
+                << "  " << setw(7) << percent(report.histogram[v]) << "%\n";
+        }
+    }
+    out << "unset:         " << report.histogram[0xF] << "  " << percent(report.histogram[0xF]) << "%\n"
+        << "max value:     " << static_cast<int>(report.maxValue) << "\n"
+        << "mean value:    " << report.meanValue << "\n"
+        << "mean, unset at depth limit + 1: " << report.meanLowerBound << "\n";
+    if (report.samples > 0)
+    {
+        out << "consistency:   " << report.violations << " violations in " << report.pairsChecked
+            << " neighbour pairs of " << report.samples << " random states\n";
+    }
+    out << defaultfloat;
+}
+
+string toJson(const DatabaseReport& report)
+{
+    ostringstream out;
+    out << "{\"kind\":\"" << getKindName(report.kind) << "\""
+        << ",\"entries\":" << report.numEntries
+        << ",\"depthLimit\":" << (report.depthLimit == 0xF ? "null" : to_string(report.depthLimit))
+        << ",\"histogram\":[";
+    for (uint8_t v = 0; v < 0xF; v++)
+    {
+        out << (v > 0 ? "," : "") << report.histogram[v];
+    }
+    out << "],\"unset\":" << report.histogram[0xF]
+        << ",\"maxValue\":" << static_cast<int>(report.maxValue)
+        << ",\"meanValue\":" << report.meanValue
+        << ",\"meanLowerBound\":" << report.meanLowerBound
+        << ",\"samples\":" << report.samples
+        << ",\"pairsChecked\":" << report.pairsChecked
+        << ",\"violations\":" << report.violations << "}";
+    return out.str();
+}
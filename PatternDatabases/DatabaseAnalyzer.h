@@ -0,0 +1,52 @@
+#pragma once
+#include <bits/stdc++.h>
+#include "DatabaseFile.h"
+using namespace std;
+
+#ifndef DATABASEANALYZER_H
+#define DATABASEANALYZER_H
+
+struct DatabaseReport
+{
+    DATABASE_KIND kind = DATABASE_KIND::GENERIC;
+    // Entries a state can index, entries past them are padding and left out of the counts.
+    uint64_t numEntries = 0;
+    // The depth the generator stopped at, 0xF when the file does not say.
+    uint32_t depthLimit = 0xF;
+    // histogram[v] entries hold v, unset entries are counted under 0xF.
+    array<uint64_t, 16> histogram{};
+    uint8_t maxValue = 0;
+    // Mean over the set entries only.
+    double meanValue = 0;
+    // Mean with every unset entry counted as depthLimit + 1, the least it can be.
+    // Equal to meanValue when the depth limit is unknown.
+    double meanLowerBound = 0;
+    // Sampled states, and parent-child pairs whose values differ by more than one move.
+    uint64_t samples = 0;
+    uint64_t pairsChecked = 0;
+    uint64_t violations = 0;
+};
+
+// Counts the values of the first numEntries nibbles of data across threads, laid out as in NibbleArray.
+array<uint64_t, 16> countNibbleValues(const uint8_t* data, size_t numEntries, unsigned int threads);
+
+/**
+ * Maps a nibble database file and reports its value distribution. For corner
+ * databases it also checks consistency: one move changes the distance from
+ * solved by at most one, so no state and its neighbours may differ by more.
+ *
+ * @param filePath the database file
+ * @param threads the threads to count and sample with
+ * @param samples the random states to check the neighbours of, 0 to skip the check
+ * @param seed the seed the states are drawn with
+ * @return the report, throwing runtime_error for files that are not nibble tables
+ */
+DatabaseReport analyzeDatabase(const string& filePath, unsigned int threads, uint64_t samples, uint64_t seed);
+
+// A report for people, one statistic per line.
+void printDatabaseReport(ostream& out, const DatabaseReport& report);
+
+// The report as one JSON object.
+string toJson(const DatabaseReport& report);
+
+#endif //DATABASEANALYZER_H
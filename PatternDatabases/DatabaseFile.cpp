@@ -0,0 +1,302 @@
+#include "DatabaseFile.h"
+#include <spanstream>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+using namespace std;
+
+namespace
+{
+    constexpr array<char, 8> MAGIC = {'R', 'C', 'S', 'P', 'D', 'B', '\0', '\0'};
+    constexpr uint32_t VERSION = 1;
+    constexpr uint32_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+    // Slicing-by-8 tables for the Castagnoli polynomial.
+    constexpr array<array<uint32_t, 256>, 8> makeCrcTables()
+    {
+        array<array<uint32_t, 256>, 8> tables{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+            }
+            tables[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            for (size_t t = 1; t < 8; ++t)
+            {
+                tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+            }
+        }
+        return tables;
+    }
+
+    constexpr auto CRC_TABLES = makeCrcTables();
+
+    vector<uint32_t> getChunkChecksums(const uint8_t* payload, const size_t payloadSize, const uint32_t chunkSize)
+    {
+        const size_t numChunks = (payloadSize + chunkSize - 1) / chunkSize;
+        vector<uint32_t> checksums(numChunks);
+        atomic<size_t> nextChunk = 0;
+        const size_t numThreads = min<size_t>(max(1u, thread::hardware_concurrency()), numChunks);
+        vector<thread> workers;
+        for (size_t t = 0; t < numThreads; ++t)
+        {
+            workers.emplace_back([&]
+            {
+                for (size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+                {
+                    const size_t offset = chunk * chunkSize;
+                    checksums[chunk] = crc32c(payload + offset, min<size_t>(chunkSize, payloadSize - offset));
+                }
+            });
+        }
+        for (thread& worker : workers)
+        {
+            worker.join();
+        }
+        return checksums;
+    }
+
+    uint32_t getHeaderChecksum(DatabaseFileHeader header, const vector<uint32_t>& chunkChecksums)
+    {
+        header.checksum = 0;
+        const uint32_t crc = crc32c(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+        return crc32c(reinterpret_cast<const uint8_t*>(chunkChecksums.data()),
+                      chunkChecksums.size() * sizeof(uint32_t), crc);
+    }
+}
+
+uint32_t crc32c(const uint8_t* data, size_t size, uint32_t crc)
+{
+    crc = ~crc;
+#ifdef __SSE4_2__
+    for (; size >= 8; size -= 8, data += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc = static_cast<uint32_t>(_mm_crc32_u64(crc, word));
+    }
+#else
+    for (; size >= 8; size -= 8, data += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        word ^= crc;
+        crc = CRC_TABLES[7][word & 0xFF] ^
+            CRC_TABLES[6][(word >> 8) & 0xFF] ^
+            CRC_TABLES[5][(word >> 16) & 0xFF] ^
+            CRC_TABLES[4][(word >> 24) & 0xFF] ^
+            CRC_TABLES[3][(word >> 32) & 0xFF] ^
+            CRC_TABLES[2][(word >> 40) & 0xFF] ^
+            CRC_TABLES[1][(word >> 48) & 0xFF] ^
+            CRC_TABLES[0][word >> 56];
+    }
+#endif
+    for (; size > 0; --size, ++data)
+    {
+        crc = (crc >> 8) ^ CRC_TABLES[0][(crc ^ *data) & 0xFF];
+    }
+    return ~crc;
+}
+
+void writeDatabaseFile(const string& filePath, DatabaseFileHeader header, const uint8_t* payload,
+                       const size_t payloadSize)
+{
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.payloadSize = payloadSize;
+    header.chunkSize = CHUNK_SIZE;
+    const vector<uint32_t> chunkChecksums = getChunkChecksums(payload, payloadSize, header.chunkSize);
+    header.checksum = getHeaderChecksum(header, chunkChecksums);
+
+    ofstream writer(filePath, ios::out | ios::binary | ios::trunc);
+    if (!writer.is_open())
+    {
+        throw runtime_error("Failed to open the file to write");
+    }
+    writer.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writer.write(reinterpret_cast<const char*>(chunkChecksums.data()),
+                 static_cast<streamsize>(chunkChecksums.size() * sizeof(uint32_t)));
+    writer.write(reinterpret_cast<const char*>(payload), static_cast<streamsize>(payloadSize));
+    if (!writer)
+    {
+        throw runtime_error("Failed to write the database file");
+    }
+    writer.close();
+}
+
+optional<DatabaseFileHeader> readDatabaseHeader(istream& reader, const size_t fileSize)
+{
+    DatabaseFileHeader header{};
+    if (fileSize < sizeof(header))
+    {
+        return nullopt;
+    }
+    reader.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!reader || header.magic != MAGIC)
+    {
+        reader.clear();
+        reader.seekg(0, ios::beg);
+        return nullopt;
+    }
+    if (header.version != VERSION)
+    {
+        throw runtime_error("Database file has unsupported format version " + to_string(header.version));
+    }
+    const size_t numChunks = header.chunkSize == 0 ? 0 : (header.payloadSize + header.chunkSize - 1) / header.chunkSize;
+    if (header.chunkSize == 0 || fileSize != sizeof(header) + numChunks * sizeof(uint32_t) + header.payloadSize)
+    {
+        throw runtime_error("Database corrupt! File size does not match its header");
+    }
+    return header;
+}
+
+void readDatabasePayload(istream& reader, const DatabaseFileHeader& header, uint8_t* dest, const VERIFY_MODE mode)
+{
+    const size_t numChunks = (header.payloadSize + header.chunkSize - 1) / header.chunkSize;
+    vector<uint32_t> chunkChecksums(numChunks);
+    reader.read(reinterpret_cast<char*>(chunkChecksums.data()),
+                static_cast<streamsize>(numChunks * sizeof(uint32_t)));
+    reader.read(reinterpret_cast<char*>(dest), static_cast<streamsize>(header.payloadSize));
+    if (!reader)
+    {
+        throw runtime_error("Database corrupt! File is truncated");
+    }
+    if (getHeaderChecksum(header, chunkChecksums) != header.checksum)
+    {
+        throw runtime_error("Database corrupt! Header checksum mismatch");
+    }
+    if (mode == VERIFY_MODE::SKIP)
+    {
+        return;
+    }
+    if (getChunkChecksums(dest, header.payloadSize, header.chunkSize) != chunkChecksums)
+    {
+        throw runtime_error("Database corrupt! Payload checksum mismatch");
+    }
+}
+
+MappedDatabaseFile::MappedDatabaseFile(const string& filePath, const VERIFY_MODE mode)
+{
+#ifdef __linux__
+    const int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw runtime_error("Failed to open " + filePath);
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        close(fd);
+        throw runtime_error("Database file " + filePath + " is empty");
+    }
+    this->fileSize = info.st_size;
+    void* addr = mmap(nullptr, this->fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+    {
+        throw runtime_error("Failed to map " + filePath);
+    }
+    this->mapping = static_cast<uint8_t*>(addr);
+    // The whole file is about to be read, so the kernel may as well read ahead.
+    madvise(this->mapping, this->fileSize, MADV_WILLNEED);
+#else
+    // Without mmap the file is read into memory, the callers see no difference.
+    ifstream reader(filePath, ios::in | ios::binary | ios::ate);
+    if (!reader.is_open())
+    {
+        throw runtime_error("Failed to open " + filePath);
+    }
+    this->fileSize = reader.tellg();
+    if (this->fileSize == 0)
+    {
+        throw runtime_error("Database file " + filePath + " is empty");
+    }
+    this->contents.resize(this->fileSize);
+    reader.seekg(0, ios::beg);
+    if (!reader.read(reinterpret_cast<char*>(this->contents.data()), static_cast<streamsize>(this->fileSize)))
+    {
+        throw runtime_error("Failed to read " + filePath);
+    }
+    this->mapping = this->contents.data();
+#endif
+
+    try
+    {
+        this->verify(filePath, mode);
+    }
+    catch (...)
+    {
+        this->release();
+        throw;
+    }
+}
+
+void MappedDatabaseFile::verify(const string& filePath, const VERIFY_MODE mode)
+{
+    ispanstream reader(span(reinterpret_cast<const char*>(this->mapping), this->fileSize));
+    this->header = readDatabaseHeader(reader, this->fileSize);
+    if (!this->header)
+    {
+        if (mode == VERIFY_MODE::STRICT)
+        {
+            throw runtime_error("Database has no header! Refusing to load it in strict mode");
+        }
+        this->payload = this->mapping;
+        this->payloadSize = this->fileSize;
+        return;
+    }
+    const size_t numChunks = (this->header->payloadSize + this->header->chunkSize - 1) / this->header->chunkSize;
+    vector<uint32_t> chunkChecksums(numChunks);
+    memcpy(chunkChecksums.data(), this->mapping + sizeof(DatabaseFileHeader), numChunks * sizeof(uint32_t));
+    this->payload = this->mapping + sizeof(DatabaseFileHeader) + numChunks * sizeof(uint32_t);
+    this->payloadSize = this->header->payloadSize;
+    if (getHeaderChecksum(*this->header, chunkChecksums) != this->header->checksum ||
+        (mode != VERIFY_MODE::SKIP &&
+            getChunkChecksums(this->payload, this->payloadSize, this->header->chunkSize) != chunkChecksums))
+    {
+        throw runtime_error("Database corrupt! Checksum mismatch in " + filePath);
+    }
+}
+
+void MappedDatabaseFile::release()
+{
+#ifdef __linux__
+    if (this->mapping)
+    {
+        munmap(this->mapping, this->fileSize);
+    }
+#endif
+    this->mapping = nullptr;
+    this->contents.clear();
+}
+
+MappedDatabaseFile::~MappedDatabaseFile()
+{
+    this->release();
+}
+
+const optional<DatabaseFileHeader>& MappedDatabaseFile::getHeader() const
+{
+    return this->header;
+}
+
+const uint8_t* MappedDatabaseFile::getPayload() const
+{
+    return this->payload;
+}
+
+size_t MappedDatabaseFile::getPayloadSize() const
+{
+    return this->payloadSize;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+#ifndef DATABASEFILE_H
+#define DATABASEFILE_H
+
+enum class DATABASE_KIND : uint32_t
+{
+    GENERIC,
+    CORNER,
+    PERIMETER,
+    CORNER_CHECKPOINT,
+    POCKET_CUBE
+};
+
+enum class DATABASE_ENCODING : uint32_t
+{
+    NIBBLE,
+    SORTED_ENTRIES,
+    // Sorted entries keyed by PackedCube.
+    PACKED_SORTED_ENTRIES
+};
+
+enum class VERIFY_MODE
+{
+    // The file must carry a header and its checksum must match.
+    STRICT,
+    // Checksums are verified when present, headerless legacy files are still accepted.
+    DEFAULT,
+    // Only the header is checked, the payload is trusted as is.
+    SKIP
+};
+
+/*
+ * On-disk layout, all fields little-endian:
+ *
+ *   DatabaseFileHeader (64 bytes)
+ *   one CRC32C per chunkSize bytes of payload
+ *   payload
+ *
+ * The header checksum covers the header (with checksum = 0) and the chunk table,
+ * so chunks can be verified independently and in parallel.
+ */
+struct DatabaseFileHeader
+{
+    array<char, 8> magic;
+    uint32_t version;
+    DATABASE_KIND kind;
+    DATABASE_ENCODING encoding;
+    uint32_t maxDepth;
+    uint64_t numEntries;
+    uint64_t numItems;
+    uint64_t payloadSize;
+    // Generation parameters.
+    uint32_t depthLimit;
+    uint32_t initValue;
+    uint32_t chunkSize;
+    uint32_t checksum;
+};
+
+static_assert(sizeof(DatabaseFileHeader) == 64);
+
+uint32_t crc32c(const uint8_t* data, size_t size, uint32_t crc = 0);
+
+// Fills in the magic, version, payload size and checksums of header and writes the file.
+void writeDatabaseFile(const string& filePath, DatabaseFileHeader header, const uint8_t* payload,
+                       size_t payloadSize);
+
+// Returns nullopt, with the reader rewound, if the file does not start with a database header.
+optional<DatabaseFileHeader> readDatabaseHeader(istream& reader, size_t fileSize);
+
+// Reads the chunk table and payload that follow the header, throwing if either is corrupt.
+void readDatabasePayload(istream& reader, const DatabaseFileHeader& header, uint8_t* dest, VERIFY_MODE mode);
+
+/*
+ * A database file mapped read-only, so tools can read a large table in place instead
+ * of copying it into memory first. Headerless legacy files map as a bare payload.
+ * Where mmap is not available the file is read into memory instead.
+ */
+class MappedDatabaseFile
+{
+    uint8_t* mapping = nullptr;
+    size_t fileSize = 0;
+    // The file's bytes when they were read instead of mapped.
+    vector<uint8_t> contents;
+    optional<DatabaseFileHeader> header;
+    const uint8_t* payload = nullptr;
+    size_t payloadSize = 0;
+
+    void verify(const string& filePath, VERIFY_MODE mode);
+    void release();
+
+public:
+    // Maps the file and verifies it as readDatabasePayload would, throwing runtime_error if it fails.
+    explicit MappedDatabaseFile(const string& filePath, VERIFY_MODE mode = VERIFY_MODE::DEFAULT);
+    MappedDatabaseFile(const MappedDatabaseFile&) = delete;
+    MappedDatabaseFile& operator=(const MappedDatabaseFile&) = delete;
+    ~MappedDatabaseFile();
+
+    // nullopt for a legacy file.
+    [[nodiscard]] const optional<DatabaseFileHeader>& getHeader() const;
+
+    [[nodiscard]] const uint8_t* getPayload() const;
+
+    [[nodiscard]] size_t getPayloadSize() const;
+};
+
+#endif //DATABASEFILE_H
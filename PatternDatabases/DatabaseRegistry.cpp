@@ -0,0 +1,85 @@
+#include "DatabaseRegistry.h"
+using namespace std;
+
+DatabaseRegistry& DatabaseRegistry::global()
+{
+    static DatabaseRegistry registry;
+    return registry;
+}
+
+optional<DatabaseIdentity> DatabaseRegistry::identify(const type_index type, const string& filePath,
+                                                      const VERIFY_MODE mode)
+{
+    error_code error;
+    const filesystem::path canonicalPath = filesystem::canonical(filePath, error);
+    if (error)
+    {
+        return nullopt;
+    }
+    const uintmax_t fileSize = filesystem::file_size(canonicalPath, error);
+    if (error)
+    {
+        return nullopt;
+    }
+    const filesystem::file_time_type modified = filesystem::last_write_time(canonicalPath, error);
+    if (error)
+    {
+        return nullopt;
+    }
+    ifstream reader(canonicalPath, ios::in | ios::binary);
+    if (!reader.is_open())
+    {
+        return nullopt;
+    }
+    const optional<DatabaseFileHeader> header = readDatabaseHeader(reader, fileSize);
+    return DatabaseIdentity{
+        type, canonicalPath.string(), mode, fileSize, modified.time_since_epoch().count(),
+        header ? header->checksum : 0
+    };
+}
+
+shared_ptr<const void> DatabaseRegistry::acquire(const DatabaseIdentity& identity,
+                                                 const function<shared_ptr<const void>()>& load)
+{
+    shared_ptr<Entry> entry;
+    {
+        lock_guard guard(entriesLock);
+        // Entries nobody holds a database or a pending load of are dropped on the way.
+        erase_if(entries, [](const auto& item)
+        {
+            return item.second.use_count() == 1 && item.second->database.expired();
+        });
+        shared_ptr<Entry>& slot = entries[identity];
+        if (!slot)
+        {
+            slot = make_shared<Entry>();
+        }
+        if (shared_ptr<const void> database = slot->database.lock())
+        {
+            return database;
+        }
+        entry = slot;
+    }
+    lock_guard loading(entry->loadLock);
+    {
+        // Another request may have loaded it while this one waited.
+        lock_guard guard(entriesLock);
+        if (shared_ptr<const void> database = entry->database.lock())
+        {
+            return database;
+        }
+    }
+    shared_ptr<const void> database = load();
+    lock_guard guard(entriesLock);
+    entry->database = database;
+    return database;
+}
+
+size_t DatabaseRegistry::getNumLoaded()
+{
+    lock_guard guard(entriesLock);
+    return ranges::count_if(entries, [](const auto& item)
+    {
+        return !item.second->database.expired();
+    });
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "bits/stdc++.h"
+#include "DatabaseFile.h"
+using namespace std;
+
+#ifndef DATABASEREGISTRY_H
+#define DATABASEREGISTRY_H
+
+// What makes two loads the same database. Files with a header are told apart by its
+// checksum, which covers the chunk checksums and so the whole payload. Legacy files
+// have none and are told apart by their size and modification time alone.
+struct DatabaseIdentity
+{
+    type_index type;
+    string canonicalPath;
+    VERIFY_MODE mode;
+    uintmax_t fileSize;
+    int64_t modified;
+    // 0 for legacy files.
+    uint32_t checksum;
+
+    auto operator<=>(const DatabaseIdentity&) const = default;
+};
+
+/*
+ * Hands out one shared, read-only copy of each database file in the process, however
+ * many solvers and threads ask for it. The registry only keeps a weak reference, so a
+ * database is freed once the last solver holding it is gone, and loaded again when
+ * it is next asked for. Concurrent requests for a database that is still loading
+ * wait for that load instead of starting their own.
+ */
+class DatabaseRegistry
+{
+    struct Entry
+    {
+        // Held while the database is loaded, so only the first request reads the file.
+        mutex loadLock;
+        // Guarded by entriesLock, which is never held while a file is read.
+        weak_ptr<const void> database;
+    };
+
+    mutex entriesLock;
+    map<DatabaseIdentity, shared_ptr<Entry>> entries;
+
+    shared_ptr<const void> acquire(const DatabaseIdentity& identity, const function<shared_ptr<const void>()>& load);
+
+public:
+    // The registry every solver in the process shares.
+    static DatabaseRegistry& global();
+
+    // Reads the identity of a database file of the given type, nullopt if it cannot be opened.
+    static optional<DatabaseIdentity> identify(type_index type, const string& filePath, VERIFY_MODE mode);
+
+    /**
+     * Returns the loaded copy of the database file, loading it first if nothing holds one.
+     *
+     * @param filePath the database file, any path to the same file gives the same copy
+     * @param mode how much of the file to verify, loads with different modes are kept apart
+     * @return the database, or null if the file cannot be opened. A corrupt file throws
+     * runtime_error, as the database's fromFile does
+     */
+    template <typename Database> requires default_initializable<Database>
+    shared_ptr<const Database> acquire(const string& filePath, const VERIFY_MODE mode = VERIFY_MODE::DEFAULT)
+    {
+        const optional<DatabaseIdentity> identity = identify(typeid(Database), filePath, mode);
+        if (!identity)
+        {
+            return nullptr;
+        }
+        return static_pointer_cast<const Database>(this->acquire(*identity, [&]() -> shared_ptr<const void>
+        {
+            const auto database = make_shared<Database>();
+            if (!database->fromFile(identity->canonicalPath, mode))
+            {
+                throw runtime_error("Cannot open database " + filePath);
+            }
+            return database;
+        }));
+    }
+
+    // The number of databases currently held by someone.
+    [[nodiscard]] size_t getNumLoaded();
+};
+
+#endif //DATABASEREGISTRY_H
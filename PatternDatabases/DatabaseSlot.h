@@ -0,0 +1,36 @@
+#pragma once
+#include "bits/stdc++.h"
+using namespace std;
+
+#ifndef DATABASESLOT_H
+#define DATABASESLOT_H
+
+/*
+ * Holds the database searches should currently use, which may be none yet, and
+ * lets another thread replace it while they run. A search takes its own reference
+ * with get() and keeps it for as long as it reads the table, so a replaced
+ * database is freed once the last search still holding it lets go.
+ */
+template <typename Database>
+class DatabaseSlot
+{
+    atomic<shared_ptr<const Database>> database;
+
+public:
+    explicit DatabaseSlot(shared_ptr<const Database> initial = nullptr) : database(std::move(initial))
+    {
+    }
+
+    [[nodiscard]] shared_ptr<const Database> get() const
+    {
+        return this->database.load();
+    }
+
+    // Only hand over a database that is fully loaded, it is visible to every search from here on.
+    void set(shared_ptr<const Database> replacement)
+    {
+        this->database.store(std::move(replacement));
+    }
+};
+
+#endif //DATABASESLOT_H
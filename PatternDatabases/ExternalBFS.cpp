@@ -0,0 +1,579 @@
+#include "ExternalBFS.h"
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+using namespace std;
+
+namespace
+{
+    constexpr size_t RECORD_SIZE = sizeof(PackedCube);
+    // Samples taken from each run to choose the merge partitions.
+    constexpr size_t SAMPLES_PER_RUN = 64;
+    constexpr size_t MIN_BUFFER_ITEMS = 4096;
+    // File descriptors left for everything but the merge readers, the writers among them.
+    constexpr size_t RESERVED_FILES = 64;
+    // Kinds of file a run leaves in the work directory, see getFileName.
+    const array<string, 3> FILE_KINDS = {"run", "merge", "layer"};
+
+    // How many files the process may have open at once.
+    size_t getOpenFileLimit()
+    {
+#ifdef __linux__
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+        {
+            return limit.rlim_cur;
+        }
+#endif
+        return 1024;
+    }
+
+    // Runs fn(0) ... fn(numThreads - 1) on their own threads and rethrows the first failure.
+    void runParallel(const unsigned numThreads, const function<void(unsigned)>& fn)
+    {
+        vector<exception_ptr> errors(numThreads);
+        vector<thread> workers;
+        for (unsigned t = 0; t < numThreads; ++t)
+        {
+            workers.emplace_back([&, t]
+            {
+                try
+                {
+                    fn(t);
+                }
+                catch (...)
+                {
+                    errors[t] = current_exception();
+                }
+            });
+        }
+        for (thread& worker : workers)
+        {
+            worker.join();
+        }
+        for (const exception_ptr& error : errors)
+        {
+            if (error)
+            {
+                rethrow_exception(error);
+            }
+        }
+    }
+
+    uint64_t getNumRecords(const string& filePath)
+    {
+        return filesystem::file_size(filePath) / RECORD_SIZE;
+    }
+
+    PackedCube readRecord(ifstream& reader, const uint64_t index)
+    {
+        PackedCube record{};
+        reader.seekg(static_cast<streamoff>(index * RECORD_SIZE));
+        reader.read(reinterpret_cast<char*>(&record), RECORD_SIZE);
+        if (!reader)
+        {
+            throw runtime_error("External BFS run file is truncated");
+        }
+        return record;
+    }
+
+    // Index of the first record of the sorted file that is not less than key.
+    uint64_t lowerBound(const string& filePath, const PackedCube& key)
+    {
+        ifstream reader(filePath, ios::in | ios::binary);
+        if (!reader.is_open())
+        {
+            throw runtime_error("Failed to open external BFS run file " + filePath);
+        }
+        uint64_t lo = 0, hi = getNumRecords(filePath);
+        while (lo < hi)
+        {
+            const uint64_t mid = lo + (hi - lo) / 2;
+            if (readRecord(reader, mid) < key)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    // Streams records [begin, end) of a run file through a fixed size buffer.
+    class RunReader
+    {
+        ifstream reader;
+        vector<PackedCube> buffer;
+        size_t pos = 0;
+        uint64_t next;
+        uint64_t end;
+
+        void refill()
+        {
+            const size_t count = min<uint64_t>(buffer.capacity(), end - next);
+            buffer.resize(count);
+            reader.read(reinterpret_cast<char*>(buffer.data()), static_cast<streamsize>(count * RECORD_SIZE));
+            if (!reader)
+            {
+                throw runtime_error("External BFS run file is truncated");
+            }
+            next += count;
+            pos = 0;
+        }
+
+    public:
+        RunReader(const string& filePath, const uint64_t begin, const uint64_t _end, const size_t bufferItems)
+            : reader(filePath, ios::in | ios::binary), next(begin), end(_end)
+        {
+            if (!reader.is_open())
+            {
+                throw runtime_error("Failed to open external BFS run file " + filePath);
+            }
+            reader.seekg(static_cast<streamoff>(begin * RECORD_SIZE));
+            buffer.reserve(bufferItems);
+        }
+
+        [[nodiscard]] bool done()
+        {
+            if (pos == buffer.size() && next != end)
+            {
+                this->refill();
+            }
+            return pos == buffer.size();
+        }
+
+        [[nodiscard]] const PackedCube& front() const
+        {
+            return buffer[pos];
+        }
+
+        void pop()
+        {
+            ++pos;
+        }
+    };
+
+    // Appends records to a run file in large sequential writes.
+    class RunWriter
+    {
+        ofstream writer;
+        vector<PackedCube> buffer;
+        function<void(const PackedCube*, size_t)> onFlush;
+
+    public:
+        uint64_t numRecords = 0;
+
+        RunWriter(const string& filePath, const size_t bufferItems,
+                  function<void(const PackedCube*, size_t)> _onFlush = {})
+            : writer(filePath, ios::out | ios::binary | ios::trunc), onFlush(std::move(_onFlush))
+        {
+            if (!writer.is_open())
+            {
+                throw runtime_error("Failed to create external BFS run file " + filePath);
+            }
+            buffer.reserve(bufferItems);
+        }
+
+        void push(const PackedCube& record)
+        {
+            buffer.push_back(record);
+            if (buffer.size() == buffer.capacity())
+            {
+                this->flush();
+            }
+        }
+
+        void flush()
+        {
+            if (buffer.empty())
+            {
+                return;
+            }
+            if (onFlush)
+            {
+                onFlush(buffer.data(), buffer.size());
+            }
+            writer.write(reinterpret_cast<const char*>(buffer.data()),
+                         static_cast<streamsize>(buffer.size() * RECORD_SIZE));
+            if (!writer)
+            {
+                throw runtime_error("Failed to write external BFS run file");
+            }
+            numRecords += buffer.size();
+            buffer.clear();
+        }
+    };
+
+    // Merges the sorted files into one sorted file, dropping duplicates.
+    void mergeFiles(const vector<string>& inputs, const string& output, const size_t bufferItems)
+    {
+        vector<unique_ptr<RunReader>> readers;
+        for (const string& filePath : inputs)
+        {
+            readers.push_back(make_unique<RunReader>(filePath, 0, getNumRecords(filePath), bufferItems));
+        }
+        typedef pair<PackedCube, size_t> HeapItem;
+        priority_queue<HeapItem, vector<HeapItem>, greater<>> heap;
+        for (size_t i = 0; i < readers.size(); ++i)
+        {
+            if (!readers[i]->done())
+            {
+                heap.emplace(readers[i]->front(), i);
+            }
+        }
+        RunWriter writer(output, bufferItems);
+        optional<PackedCube> last;
+        while (!heap.empty())
+        {
+            const auto [state, i] = heap.top();
+            heap.pop();
+            readers[i]->pop();
+            if (!readers[i]->done())
+            {
+                heap.emplace(readers[i]->front(), i);
+            }
+            if (last != state)
+            {
+                writer.push(state);
+                last = state;
+            }
+        }
+        writer.flush();
+    }
+}
+
+ExternalBFS::ExternalBFS(const string& _workDir, const size_t _memoryBudget, const unsigned _numThreads)
+    : workDir(_workDir), memoryBudget(_memoryBudget), numThreads(max(1u, _numThreads))
+{
+}
+
+void ExternalBFS::setProjection(Projection _projection)
+{
+    this->projection = std::move(_projection);
+}
+
+void ExternalBFS::setVisitor(Visitor _visitor)
+{
+    this->visitor = std::move(_visitor);
+}
+
+string ExternalBFS::getFileName(const string& kind, const uint8_t depth, const size_t part) const
+{
+    return (filesystem::path(this->workDir) / (kind + "-" + to_string(depth) + "-" + to_string(part) + ".bin")).string();
+}
+
+/*
+ * Expands the layer one memory sized chunk at a time. Every thread expands a
+ * slice of the chunk, then sorts and dedupes its children into its own run file.
+ */
+vector<string> ExternalBFS::writeRuns(const Layer& layer, const uint8_t depth) const
+{
+    // Each parent needs room for itself and its 18 children.
+    const size_t chunkItems = max<size_t>(this->memoryBudget / RECORD_SIZE / 19, this->numThreads);
+    vector<string> runs;
+    vector<PackedCube> parents;
+    parents.reserve(chunkItems);
+
+    const auto expandChunk = [&]
+    {
+        const size_t firstRun = runs.size();
+        for (unsigned t = 0; t < this->numThreads; ++t)
+        {
+            runs.push_back(this->getFileName("run", depth, firstRun + t));
+        }
+        runParallel(this->numThreads, [&](const unsigned t)
+        {
+            const size_t begin = parents.size() * t / this->numThreads;
+            const size_t end = parents.size() * (t + 1) / this->numThreads;
+            vector<PackedCube> children;
+            children.reserve((end - begin) * 18);
+            RubiksCubeBitboard cube;
+            for (size_t i = begin; i < end; ++i)
+            {
+                parents[i].unpack(cube);
+                for (int m = 0; m < 18; ++m)
+                {
+                    const auto move = static_cast<RubiksCube::MOVE>(m);
+                    cube.move(move);
+                    const PackedCube child = PackedCube::pack(cube);
+                    children.push_back(this->projection ? this->projection(child) : child);
+                    cube.invert(move);
+                }
+            }
+            ranges::sort(children);
+            const auto [first, last] = ranges::unique(children);
+            children.erase(first, last);
+            RunWriter writer(runs[firstRun + t], children.size() + 1);
+            for (const PackedCube& child : children)
+            {
+                writer.push(child);
+            }
+            writer.flush();
+        });
+        parents.clear();
+    };
+
+    for (const string& filePath : layer.files)
+    {
+        RunReader reader(filePath, 0, getNumRecords(filePath), MIN_BUFFER_ITEMS * 16);
+        while (!reader.done())
+        {
+            parents.push_back(reader.front());
+            reader.pop();
+            if (parents.size() == chunkItems)
+            {
+                expandChunk();
+            }
+        }
+    }
+    if (!parents.empty())
+    {
+        expandChunk();
+    }
+    return runs;
+}
+
+size_t ExternalBFS::getMaxOpenReaders() const
+{
+    const size_t byMemory = this->memoryBudget / (MIN_BUFFER_ITEMS * RECORD_SIZE);
+    const size_t limit = getOpenFileLimit();
+    const size_t byFiles = limit > RESERVED_FILES ? limit - RESERVED_FILES : 1;
+    return max<size_t>(2, min(byMemory, byFiles));
+}
+
+/*
+ * Merges runs in groups until at most maxRuns are left. Groups are merged
+ * concurrently, each one as wide as the open reader budget allows across the
+ * threads, and the runs they were made from are removed as they go.
+ */
+vector<string> ExternalBFS::reduceRuns(vector<string> runs, const size_t maxRuns, const uint8_t depth) const
+{
+    const size_t maxReaders = this->getMaxOpenReaders();
+    for (size_t pass = 0; runs.size() > max<size_t>(1, maxRuns); ++pass)
+    {
+        const size_t threads = min<size_t>(this->numThreads, max<size_t>(1, maxReaders / 2));
+        // A group reads its inputs and writes one file, which counts against the budget like a reader.
+        const size_t fanIn = max<size_t>(2, maxReaders / threads - 1);
+        const size_t numGroups = (runs.size() + fanIn - 1) / fanIn;
+        const size_t bufferItems = max(MIN_BUFFER_ITEMS, this->memoryBudget / RECORD_SIZE / (threads * (fanIn + 1)));
+        vector<string> merged(numGroups);
+        for (size_t group = 0; group < numGroups; ++group)
+        {
+            merged[group] = this->getFileName("merge" + to_string(pass), depth, group);
+        }
+        atomic<size_t> nextGroup = 0;
+        runParallel(static_cast<unsigned>(min(threads, numGroups)), [&](unsigned)
+        {
+            for (size_t group = nextGroup++; group < numGroups; group = nextGroup++)
+            {
+                const auto first = runs.begin() + static_cast<ptrdiff_t>(group * fanIn);
+                const vector<string> inputs(first, first + static_cast<ptrdiff_t>(min(fanIn, runs.size() - group * fanIn)));
+                mergeFiles(inputs, merged[group], bufferItems);
+                for (const string& filePath : inputs)
+                {
+                    filesystem::remove(filePath);
+                }
+            }
+        });
+        runs = std::move(merged);
+    }
+    return runs;
+}
+
+/*
+ * Merges the runs into the next layer. The key space is cut into one range per
+ * thread at quantiles sampled from the runs, and every thread merges its range
+ * of all the runs while skipping the states of the current and previous layers.
+ */
+ExternalBFS::Layer ExternalBFS::mergeRuns(vector<string>& runs, const Layer& current, const Layer& previous,
+                                          const uint8_t depth) const
+{
+    vector<string> seenFiles = current.files;
+    seenFiles.insert(seenFiles.end(), previous.files.begin(), previous.files.end());
+    // Every partition reads all the runs and seen files at once, so the partitions and the
+    // runs they merge are cut down until their readers fit the memory budget and the file limit.
+    const size_t maxReaders = this->getMaxOpenReaders();
+    const size_t maxParts = max<size_t>(1, min<size_t>(this->numThreads, maxReaders / (seenFiles.size() + 3)));
+    const size_t readersPerPart = maxReaders / maxParts;
+    const size_t maxRuns = readersPerPart > seenFiles.size() + 3 ? readersPerPart - seenFiles.size() - 1 : 2;
+    runs = this->reduceRuns(std::move(runs), maxRuns, depth);
+
+    vector<PackedCube> samples;
+    for (const string& filePath : runs)
+    {
+        const uint64_t numRecords = getNumRecords(filePath);
+        if (numRecords == 0) continue;
+        ifstream reader(filePath, ios::in | ios::binary);
+        const uint64_t step = max<uint64_t>(1, numRecords / SAMPLES_PER_RUN);
+        for (uint64_t i = 0; i < numRecords; i += step)
+        {
+            samples.push_back(readRecord(reader, i));
+        }
+    }
+    ranges::sort(samples);
+    vector<PackedCube> splitters;
+    for (size_t t = 1; t < maxParts && !samples.empty(); ++t)
+    {
+        const PackedCube splitter = samples[samples.size() * t / maxParts];
+        if (splitters.empty() || splitters.back() < splitter)
+        {
+            splitters.push_back(splitter);
+        }
+    }
+    const size_t numParts = splitters.size() + 1;
+    const size_t bufferItems = max(MIN_BUFFER_ITEMS, this->memoryBudget / RECORD_SIZE /
+                                   (numParts * (runs.size() + seenFiles.size() + 1)));
+
+    Layer next;
+    vector<uint64_t> counts(numParts);
+    for (size_t part = 0; part < numParts; ++part)
+    {
+        next.files.push_back(this->getFileName("layer", depth, part));
+    }
+    runParallel(static_cast<unsigned>(numParts), [&](const unsigned part)
+    {
+        const auto openRange = [&](const string& filePath)
+        {
+            const uint64_t begin = part == 0 ? 0 : lowerBound(filePath, splitters[part - 1]);
+            const uint64_t end = part == numParts - 1 ? getNumRecords(filePath) : lowerBound(filePath, splitters[part]);
+            return make_unique<RunReader>(filePath, begin, end, bufferItems);
+        };
+        vector<unique_ptr<RunReader>> readers, seen;
+        for (const string& filePath : runs)
+        {
+            readers.push_back(openRange(filePath));
+        }
+        for (const string& filePath : seenFiles)
+        {
+            seen.push_back(openRange(filePath));
+        }
+
+        typedef pair<PackedCube, size_t> HeapItem;
+        priority_queue<HeapItem, vector<HeapItem>, greater<>> heap;
+        for (size_t i = 0; i < readers.size(); ++i)
+        {
+            if (!readers[i]->done())
+            {
+                heap.emplace(readers[i]->front(), i);
+            }
+        }
+
+        RunWriter writer(next.files[part], bufferItems, [&](const PackedCube* states, const size_t count)
+        {
+            if (this->visitor)
+            {
+                this->visitor(depth, states, count);
+            }
+        });
+        optional<PackedCube> last;
+        while (!heap.empty())
+        {
+            const auto [state, i] = heap.top();
+            heap.pop();
+            readers[i]->pop();
+            if (!readers[i]->done())
+            {
+                heap.emplace(readers[i]->front(), i);
+            }
+            if (last == state) continue;
+            last = state;
+            bool isSeen = false;
+            for (const unique_ptr<RunReader>& reader : seen)
+            {
+                while (!reader->done() && reader->front() < state)
+                {
+                    reader->pop();
+                }
+                isSeen = isSeen || (!reader->done() && reader->front() == state);
+            }
+            if (!isSeen)
+            {
+                writer.push(state);
+            }
+        }
+        writer.flush();
+        counts[part] = writer.numRecords;
+    });
+    next.numStates = accumulate(counts.begin(), counts.end(), uint64_t(0));
+    return next;
+}
+
+void ExternalBFS::removeLayer(const Layer& layer)
+{
+    for (const string& filePath : layer.files)
+    {
+        filesystem::remove(filePath);
+    }
+}
+
+void ExternalBFS::removeWorkFiles() const
+{
+    error_code error;
+    for (const filesystem::directory_entry& entry : filesystem::directory_iterator(this->workDir, error))
+    {
+        const string name = entry.path().filename().string();
+        const bool isWorkFile = name.ends_with(".bin") && ranges::any_of(FILE_KINDS, [&](const string& kind)
+        {
+            return name.starts_with(kind);
+        });
+        if (isWorkFile)
+        {
+            filesystem::remove(entry.path(), error);
+        }
+    }
+}
+
+vector<uint64_t> ExternalBFS::run(const uint8_t maxDepth)
+{
+    filesystem::create_directories(this->workDir);
+    try
+    {
+        return this->search(maxDepth);
+    }
+    catch (...)
+    {
+        // A failed run would otherwise leave a layer's worth of runs behind.
+        this->removeWorkFiles();
+        throw;
+    }
+}
+
+vector<uint64_t> ExternalBFS::search(const uint8_t maxDepth)
+{
+    const RubiksCubeBitboard solvedCube;
+    const PackedCube solved = this->projection
+                                  ? this->projection(PackedCube::pack(solvedCube))
+                                  : PackedCube::pack(solvedCube);
+    Layer previous, current;
+    current.files.push_back(this->getFileName("layer", 0, 0));
+    current.numStates = 1;
+    {
+        RunWriter writer(current.files[0], 1);
+        writer.push(solved);
+    }
+    if (this->visitor)
+    {
+        this->visitor(0, &solved, 1);
+    }
+
+    vector<uint64_t> layerSizes = {1};
+    for (uint8_t depth = 1; depth <= maxDepth; ++depth)
+    {
+        vector<string> runs = this->writeRuns(current, depth);
+        Layer next = this->mergeRuns(runs, current, previous, depth);
+        for (const string& filePath : runs)
+        {
+            filesystem::remove(filePath);
+        }
+        removeLayer(previous);
+        previous = std::move(current);
+        current = std::move(next);
+        if (current.numStates == 0) break;
+        layerSizes.push_back(current.numStates);
+    }
+    removeLayer(previous);
+    removeLayer(current);
+    return layerSizes;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "bits/stdc++.h"
+#include "../Model/RubiksCubeBitboard.cpp"
+#include "../Model/PackedCube.h"
+
+#ifndef EXTERNALBFS_H
+#define EXTERNALBFS_H
+
+/*
+ * Breadth-first enumeration of the cube's state space with the layers kept on disk.
+ *
+ * Each layer is a set of sorted run files of PackedCube. To build the next
+ * layer, the current one is streamed in chunks that fit the memory budget. Each
+ * chunk is expanded and sorted across the worker threads and written out as runs.
+ * The runs are then merged in key-range partitions, one per thread, and anything
+ * already in the current or previous layer is dropped. No move leads further
+ * back than that, so this delayed duplicate detection is exact and RAM holds only
+ * one chunk and the merge buffers. When there are more runs than the memory budget
+ * and the open file limit allow readers for, they are merged in several passes.
+ */
+class ExternalBFS
+{
+public:
+    // Called with a sorted batch of the states of a layer. Partitions are merged
+    // concurrently, so it has to be safe to call from several threads at once.
+    using Visitor = function<void(uint8_t depth, const PackedCube* states, size_t count)>;
+
+    // Maps a state to the state that is actually stored, eg- clearing the corner
+    // word to enumerate edges only. It must be compatible with the moves: states
+    // with equal projections must have children with equal projections.
+    using Projection = function<PackedCube(const PackedCube&)>;
+
+private:
+    // A layer is a list of sorted files whose key ranges follow each other.
+    struct Layer
+    {
+        vector<string> files;
+        uint64_t numStates = 0;
+    };
+
+    string workDir;
+    size_t memoryBudget;
+    unsigned numThreads;
+    Projection projection;
+    Visitor visitor;
+
+    [[nodiscard]] string getFileName(const string& kind, uint8_t depth, size_t part) const;
+
+    [[nodiscard]] vector<string> writeRuns(const Layer& layer, uint8_t depth) const;
+
+    // Readers that may be open at once, each one holding a buffer and a file descriptor.
+    [[nodiscard]] size_t getMaxOpenReaders() const;
+
+    [[nodiscard]] vector<string> reduceRuns(vector<string> runs, size_t maxRuns, uint8_t depth) const;
+
+    // Merges the runs, leaving the names of the files it read last in runs for the caller to remove.
+    [[nodiscard]] Layer mergeRuns(vector<string>& runs, const Layer& current, const Layer& previous,
+                                  uint8_t depth) const;
+
+    static void removeLayer(const Layer& layer);
+
+    void removeWorkFiles() const;
+
+    vector<uint64_t> search(uint8_t maxDepth);
+
+public:
+    explicit ExternalBFS(const string& _workDir, size_t _memoryBudget = size_t(1) << 30,
+                         unsigned _numThreads = thread::hardware_concurrency());
+
+    void setProjection(Projection _projection);
+
+    void setVisitor(Visitor _visitor);
+
+    // Enumerates every state up to maxDepth moves from the solved cube and
+    // returns the number of states at each depth. If it fails, its files are
+    // removed from the work directory before the error is rethrown.
+    vector<uint64_t> run(uint8_t maxDepth);
+};
+
+#endif //EXTERNALBFS_H
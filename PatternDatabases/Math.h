@@ -4,8 +4,19 @@
 #ifndef MATH_H
 #define MATH_H
 
-uint32_t factorial(uint32_t n);
-uint32_t pick(uint32_t n, uint32_t k);
-uint32_t choose(uint32_t n, uint32_t k);
+constexpr uint32_t factorial(const uint32_t n)
+{
+    return n <= 1 ? 1 : n * factorial(n - 1);
+}
+
+constexpr uint32_t pick(const uint32_t n, const uint32_t k)
+{
+    return factorial(n) / factorial(n - k);
+}
+
+constexpr uint32_t choose(const uint32_t n, const uint32_t k)
+{
+    return (n < k) ? 0 : factorial(n) / (factorial(n - k) * factorial(k));
+}
 
 #endif //MATH_H
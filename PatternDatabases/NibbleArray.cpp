@@ -1,8 +1,8 @@
 #include "NibbleArray.h"
 using namespace std;
 
-NibbleArray::NibbleArray(const size_t size, const uint8_t val) :
-    size(size), arr(size / 2 + 1, val)
+NibbleArray::NibbleArray(const size_t size, const uint8_t val, const StoragePlacement placement) :
+    size(size), arr(size / 2 + 1, val, placement)
 {
 }
 
@@ -10,7 +10,7 @@ uint8_t NibbleArray::get(const size_t pos) const
 {
     const size_t i = pos / 2;
     assert(pos <= this->size);
-    const uint8_t val = this->arr.at(i);
+    const uint8_t val = this->arr.data()[i];
     if (pos % 2)
     {
         return val & 0x0F;
@@ -21,18 +21,23 @@ uint8_t NibbleArray::get(const size_t pos) const
 void NibbleArray::set(const size_t pos, const uint8_t val)
 {
     const size_t i = pos / 2;
-    const uint8_t currVal = this->arr.at(i);
     assert(pos <= this->size);
+    const uint8_t currVal = this->arr.data()[i];
     if (pos % 2)
     {
-        this->arr.at(i) = (currVal & 0xF0) | (val & 0x0F);
+        this->arr.data()[i] = (currVal & 0xF0) | (val & 0x0F);
     }
     else
     {
-        this->arr.at(i) = (currVal & 0x0F) | (val << 4);
+        this->arr.data()[i] = (currVal & 0x0F) | (val << 4);
     }
 }
 
+void NibbleArray::prefetch(const size_t pos) const
+{
+    __builtin_prefetch(this->arr.data() + pos / 2);
+}
+
 uint8_t* NibbleArray::data()
 {
     return this->arr.data();
@@ -48,6 +53,11 @@ size_t NibbleArray::storageSize() const
     return this->arr.size();
 }
 
+string NibbleArray::getBacking() const
+{
+    return this->arr.describe();
+}
+
 void NibbleArray::inflate(vector<uint8_t>& dest) const
 {
     dest.reserve(this->size);
@@ -59,5 +69,5 @@ void NibbleArray::inflate(vector<uint8_t>& dest) const
 
 void NibbleArray::reset(const uint8_t val)
 {
-    ranges::fill(this->arr, val);
+    memset(this->arr.data(), val, this->arr.size());
 }
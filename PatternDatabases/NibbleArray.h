@@ -1,5 +1,6 @@
 #pragma once
 #include <bits/stdc++.h>
+#include "StorageBuffer.h"
 using namespace std;
 
 #ifndef NIBBLEARRAY_H
@@ -8,21 +9,25 @@ using namespace std;
 class NibbleArray
 {
     size_t size;
-    std::vector<uint8_t> arr;
+    StorageBuffer arr;
 
 public:
-    explicit NibbleArray(size_t size, uint8_t val = 0xFF);
+    explicit NibbleArray(size_t size, uint8_t val = 0xFF, StoragePlacement placement = {});
 
     [[nodiscard]] uint8_t get(size_t pos) const;
 
     void set(size_t pos, uint8_t val);
 
+    void prefetch(size_t pos) const;
+
     unsigned char* data();
 
     [[nodiscard]] const unsigned char* data() const;
 
     [[nodiscard]] size_t storageSize() const;
 
+    [[nodiscard]] string getBacking() const;
+
     void inflate(vector<uint8_t>& dest) const;
 
     void reset(uint8_t val = 0xFF);
@@ -0,0 +1,111 @@
+#include "NibbleArrayStress.h"
+#include "ConcurrentNibbleArray.h"
+using namespace std;
+
+namespace
+{
+    // Four words, so most writes land next to another thread's entry.
+    constexpr size_t STRESS_ENTRIES = 64;
+    constexpr uint64_t OPERATIONS_PER_THREAD = 20000;
+    constexpr uint64_t BENCHMARK_SETS_PER_THREAD = 2000000;
+    // Sixteen nibbles to a word and eight words to a cache line.
+    constexpr size_t ENTRIES_PER_CACHE_LINE = 128;
+
+    // Runs body(thread) on threads threads and returns the seconds until all of them finished.
+    template <typename Body>
+    double runThreads(const unsigned threads, const Body& body)
+    {
+        const auto start = chrono::steady_clock::now();
+        {
+            vector<jthread> workers;
+            workers.reserve(threads);
+            for (unsigned t = 0; t < threads; t++)
+            {
+                workers.emplace_back([&body, t] { body(t); });
+            }
+        }
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    double benchmarkSets(const unsigned threads, const bool contended)
+    {
+        ConcurrentNibbleArray nibbles(threads * ENTRIES_PER_CACHE_LINE);
+        const double seconds = runThreads(threads, [&](const unsigned t)
+        {
+            // Contended threads all write word 0, at most sixteen of them on distinct nibbles.
+            const size_t base = contended ? t % 16 : t * ENTRIES_PER_CACHE_LINE;
+            const size_t stride = contended ? 0 : 16;
+            for (uint64_t i = 0; i < BENCHMARK_SETS_PER_THREAD; i++)
+            {
+                nibbles.set(base + (i % 8) * stride, static_cast<uint8_t>(i & 0x0F));
+            }
+        });
+        return static_cast<double>(threads * BENCHMARK_SETS_PER_THREAD) / seconds;
+    }
+}
+
+NibbleStressReport stressNibbleArray(const unsigned int threads, const uint64_t rounds, const uint64_t seed)
+{
+    NibbleStressReport report;
+    report.threads = max(1u, threads);
+    report.rounds = rounds;
+    ConcurrentNibbleArray nibbles(STRESS_ENTRIES);
+    vector<array<uint8_t, STRESS_ENTRIES>> written(report.threads);
+    for (uint64_t round = 0; round < rounds; round++)
+    {
+        nibbles.reset();
+        runThreads(report.threads, [&](const unsigned t)
+        {
+            mt19937_64 rng(seed ^ (round * report.threads + t) * 0x9E3779B97F4A7C15ull);
+            auto& smallest = written[t];
+            smallest.fill(0x0F);
+            for (uint64_t i = 0; i < OPERATIONS_PER_THREAD; i++)
+            {
+                const size_t pos = rng() % STRESS_ENTRIES;
+                // 0 is left out, or the entries would settle at it after a few writes.
+                const auto val = static_cast<uint8_t>(1 + rng() % 14);
+                nibbles.setIfSmaller(pos, val);
+                smallest[pos] = min(smallest[pos], val);
+            }
+        });
+        for (size_t pos = 0; pos < STRESS_ENTRIES; pos++)
+        {
+            uint8_t expected = 0x0F;
+            for (const auto& smallest : written)
+            {
+                expected = min(expected, smallest[pos]);
+            }
+            if (nibbles.get(pos) != expected)
+            {
+                ++report.mismatches;
+            }
+        }
+        report.operations += report.threads * OPERATIONS_PER_THREAD;
+    }
+    report.contendedSetsPerSecond = benchmarkSets(report.threads, true);
+    report.disjointSetsPerSecond = benchmarkSets(report.threads, false);
+    return report;
+}
+
+void printNibbleStressReport(ostream& out, const NibbleStressReport& report)
+{
+    out << fixed << setprecision(1)
+        << "threads:       " << report.threads << "\n"
+        << "stress:        " << report.mismatches << " mismatched entries after " << report.operations
+        << " setIfSmaller calls in " << report.rounds << " rounds\n"
+        << "contended set: " << report.contendedSetsPerSecond / 1e6 << " M/s\n"
+        << "disjoint set:  " << report.disjointSetsPerSecond / 1e6 << " M/s\n"
+        << defaultfloat;
+}
+
+string toJson(const NibbleStressReport& report)
+{
+    ostringstream out;
+    out << "{\"threads\":" << report.threads
+        << ",\"rounds\":" << report.rounds
+        << ",\"operations\":" << report.operations
+        << ",\"mismatches\":" << report.mismatches
+        << ",\"contendedSetsPerSecond\":" << report.contendedSetsPerSecond
+        << ",\"disjointSetsPerSecond\":" << report.disjointSetsPerSecond << "}";
+    return out.str();
+}
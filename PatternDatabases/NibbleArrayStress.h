@@ -0,0 +1,41 @@
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+#ifndef NIBBLEARRAYSTRESS_H
+#define NIBBLEARRAYSTRESS_H
+
+struct NibbleStressReport
+{
+    unsigned threads = 0;
+    // Stress test: rounds of concurrent setIfSmaller calls on a few shared words,
+    // and the entries that did not end up at the smallest value written to them.
+    uint64_t rounds = 0;
+    uint64_t operations = 0;
+    uint64_t mismatches = 0;
+    // Benchmark: set calls per second when every thread writes the same word,
+    // and when each thread writes words of its own cache line.
+    double contendedSetsPerSecond = 0;
+    double disjointSetsPerSecond = 0;
+};
+
+/**
+ * Checks ConcurrentNibbleArray under contention. Every thread lowers random
+ * entries of the same few 64-bit words, so neighbouring nibbles are written at
+ * once, and afterwards each entry must hold the minimum of what was written to it.
+ * Then it times set on shared words against set on disjoint words.
+ *
+ * @param threads the threads to write with
+ * @param rounds the stress rounds, the array is reset before each
+ * @param seed the seed the positions and values are drawn with
+ * @return the report, mismatches is 0 when the array kept every write
+ */
+NibbleStressReport stressNibbleArray(unsigned int threads, uint64_t rounds, uint64_t seed);
+
+// A report for people, one statistic per line.
+void printNibbleStressReport(ostream& out, const NibbleStressReport& report);
+
+// The report as one JSON object.
+string toJson(const NibbleStressReport& report);
+
+#endif //NIBBLEARRAYSTRESS_H
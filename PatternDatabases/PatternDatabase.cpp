@@ -1,29 +1,19 @@
 #include "PatternDatabase.h"
 using namespace std;
 
-PatternDatabase::PatternDatabase(const size_t size) :
-    database(size, 0xFF), size(size), numItems(0)
+PatternDatabase::PatternDatabase(const size_t size, const StoragePlacement placement) :
+    table(size, 0xFF, placement)
 {
 }
 
-PatternDatabase::PatternDatabase(const size_t size, const uint8_t init_val) :
-    database(size, init_val), size(size), numItems(0)
+PatternDatabase::PatternDatabase(const size_t size, const uint8_t init_val, const StoragePlacement placement) :
+    table(size, init_val, placement)
 {
 }
 
 bool PatternDatabase::setNumMoves(const uint32_t ind, const uint8_t numMoves)
 {
-    const uint8_t oldMoves = this->getNumMoves(ind);
-    if (oldMoves == 0xF)
-    {
-        ++this->numItems;
-    }
-    if (oldMoves > numMoves)
-    {
-        this->database.set(ind, numMoves);
-        return true;
-    }
-    return false;
+    return this->table.setNumMoves(ind, numMoves);
 }
 
 bool PatternDatabase::setNumMoves(const RubiksCube& cube, const uint8_t numMoves)
@@ -33,7 +23,7 @@ bool PatternDatabase::setNumMoves(const RubiksCube& cube, const uint8_t numMoves
 
 uint8_t PatternDatabase::getNumMoves(const uint32_t ind) const
 {
-    return this->database.get(ind);
+    return this->table.getNumMoves(ind);
 }
 
 uint8_t PatternDatabase::getNumMoves(const RubiksCube& cube) const
@@ -41,72 +31,87 @@ uint8_t PatternDatabase::getNumMoves(const RubiksCube& cube) const
     return this->getNumMoves(this->getDatabaseIndex(cube));
 }
 
+void PatternDatabase::getNumMovesBatch(const uint32_t* ind, uint8_t* out, const size_t n) const
+{
+    this->table.getNumMovesBatch(ind, out, n);
+}
+
 size_t PatternDatabase::getSize() const
 {
-    return this->size;
+    return this->table.getSize();
 }
 
 size_t PatternDatabase::getNumItems() const
 {
-    return this->numItems;
+    return this->table.getNumItems();
 }
 
 bool PatternDatabase::isFull() const
 {
-    return this->numItems == this->size;
+    return this->table.isFull();
+}
+
+string PatternDatabase::getStorageBacking() const
+{
+    return this->table.getStorageBacking();
+}
+
+DATABASE_KIND PatternDatabase::getKind() const
+{
+    return DATABASE_KIND::GENERIC;
+}
+
+uint8_t PatternDatabase::getMaxDepth() const
+{
+    return this->table.getMaxDepth();
+}
+
+uint8_t PatternDatabase::getDepthLimit() const
+{
+    return this->table.getDepthLimit();
+}
+
+void PatternDatabase::setDepthLimit(const uint8_t limit)
+{
+    this->table.setDepthLimit(limit);
+}
+
+uint8_t PatternDatabase::getUnsetBound() const
+{
+    return this->table.getUnsetBound();
 }
 
 void PatternDatabase::toFile(const string& filePath) const
 {
-    ofstream writer(filePath, ios::out | ios::binary | ios::trunc);
+    this->table.toFile(filePath, this->getKind());
+}
 
-    if (!writer.is_open())
-    {
-        throw runtime_error("Failed to open the file to write");
-    }
+bool PatternDatabase::fromFile(const string& filePath, const VERIFY_MODE mode)
+{
+    return this->table.fromFile(filePath, mode, this->getKind());
+}
 
-    writer.write(
-        reinterpret_cast<const char*>(this->database.data()),
-        this->database.storageSize()
-    );
+const uint8_t* PatternDatabase::data() const
+{
+    return this->table.data();
+}
 
-    writer.close();
+size_t PatternDatabase::storageSize() const
+{
+    return this->table.storageSize();
 }
 
-bool PatternDatabase::fromFile(const string& filePath)
+void PatternDatabase::fromData(const uint8_t* data, const size_t numItems)
 {
-    ifstream reader(filePath, ios::in | ios::ate);
-    if (!reader.is_open())
-    {
-        return false;
-    }
-    if (const size_t fileSize = reader.tellg(); fileSize != this->database.storageSize())
-    {
-        reader.close();
-        throw runtime_error("Database corrupt! Failed to open Reader");
-    }
-    reader.seekg(0, ios::beg);
-    reader.read(
-        reinterpret_cast<char*>(this->database.data()),
-        this->database.storageSize()
-    );
-    reader.close();
-    this->numItems = this->size;
-    return true;
+    this->table.fromData(data, numItems);
 }
 
 vector<uint8_t> PatternDatabase::inflate() const
 {
-    vector<uint8_t> inflated;
-    this->database.inflate(inflated);
-    return inflated;
+    return this->table.inflate();
 }
 
 void PatternDatabase::reset()
 {
-    if (this->numItems != 0)
-    {
-        this->database.reset(0xFF);
-        this->numItems = 0;
-    }
+    this->table.reset();
 }
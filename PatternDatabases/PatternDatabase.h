@@ -1,20 +1,30 @@
 #pragma once
 #include "bits/stdc++.h"
 #include "../Model/RubiksCube.h"
-#include "NibbleArray.h"
+#include "BasicPatternDatabase.h"
 
 #ifndef PATTERNDATABASE_H
 #define PATTERNDATABASE_H
 
+/*
+ * The pattern database interface for code that picks its table at run time.
+ * Subclasses supply the index function, every call is forwarded to a
+ * BasicPatternDatabase, which searches should use directly when they can.
+ */
 class PatternDatabase
 {
-    NibbleArray database;
-    size_t size;
-    size_t numItems;
+    // Entries are indexed by the subclass, so the table has no index function of its own.
+    struct RuntimeIndexer
+    {
+        static constexpr DATABASE_KIND KIND = DATABASE_KIND::GENERIC;
+    };
+
+    BasicPatternDatabase<RuntimeIndexer> table;
 
 public:
-    explicit PatternDatabase(size_t size);
-    PatternDatabase(size_t size, uint8_t init_val);
+    explicit PatternDatabase(size_t size, StoragePlacement placement = {});
+    PatternDatabase(size_t size, uint8_t init_val, StoragePlacement placement = {});
+    virtual ~PatternDatabase() = default;
 
     [[nodiscard]] virtual uint32_t getDatabaseIndex(const RubiksCube& cube) const = 0;
 
@@ -26,15 +36,41 @@ public:
 
     [[nodiscard]] virtual uint8_t getNumMoves(uint32_t ind) const;
 
+    // Prefetches all n entries before reading any of them, so the cache misses overlap.
+    virtual void getNumMovesBatch(const uint32_t* ind, uint8_t* out, size_t n) const;
+
     [[nodiscard]] virtual size_t getSize() const;
 
     [[nodiscard]] virtual size_t getNumItems() const;
 
     [[nodiscard]] virtual bool isFull() const;
 
+    [[nodiscard]] virtual DATABASE_KIND getKind() const;
+
+    // The largest stored number of moves, ignoring unset (0xF) entries.
+    [[nodiscard]] virtual uint8_t getMaxDepth() const;
+
+    [[nodiscard]] virtual uint8_t getDepthLimit() const;
+
+    // Records the depth the generator stopped at, so it is kept in the file header.
+    virtual void setDepthLimit(uint8_t limit);
+
+    // The fewest moves an unset (0xF) entry stands for, see BasicPatternDatabase::getUnsetBound.
+    [[nodiscard]] virtual uint8_t getUnsetBound() const;
+
+    // Describes the memory backing the table, eg- "hugetlb" or "thp+numa-interleave".
+    [[nodiscard]] virtual string getStorageBacking() const;
+
     virtual void toFile(const string& filePath) const;
 
-    virtual bool fromFile(const string& filePath);
+    virtual bool fromFile(const string& filePath, VERIFY_MODE mode = VERIFY_MODE::DEFAULT);
+
+    // Raw nibble bytes of the table, eg- for generator checkpoints.
+    [[nodiscard]] virtual const uint8_t* data() const;
+
+    [[nodiscard]] virtual size_t storageSize() const;
+
+    virtual void fromData(const uint8_t* data, size_t numItems);
 
     [[nodiscard]] virtual vector<uint8_t> inflate() const;
 
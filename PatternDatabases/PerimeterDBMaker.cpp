@@ -0,0 +1,57 @@
+#include "PerimeterDBMaker.h"
+using namespace std;
+
+PerimeterDBMaker::PerimeterDBMaker(const string& _fileName, const uint8_t depth) : perimeterDB(depth)
+{
+    fileName = _fileName;
+}
+
+void PerimeterDBMaker::bfs()
+{
+    const RubiksCubeBitboard cube;
+    queue<PackedCube> q;
+    unordered_set<PackedCube, HashPackedCube> visited;
+    const PackedCube solvedKey = PackedCube::pack(cube);
+    q.push(solvedKey);
+    visited.insert(solvedKey);
+    // The solving move of the solved cube is never read, any value will do.
+    perimeterDB.add(solvedKey, 0, RubiksCube::MOVE::L);
+    int curr_depth = 0;
+    while (!q.empty())
+    {
+        const unsigned n = q.size();
+        curr_depth++;
+        if (curr_depth > perimeterDB.getDepth()) break;
+        for (unsigned counter = 0; counter < n; counter++)
+        {
+            RubiksCubeBitboard node;
+            q.front().unpack(node);
+            q.pop();
+            for (int i = 0; i < 18; i++)
+            {
+                const auto curr_move = static_cast<RubiksCube::MOVE>(i);
+                node.move(curr_move);
+                const PackedCube key = PackedCube::pack(node);
+                if (visited.insert(key).second)
+                {
+                    perimeterDB.add(key, curr_depth, RubiksCube::getInverseMove(curr_move));
+                    q.push(key);
+                }
+                node.invert(curr_move);
+            }
+        }
+    }
+    perimeterDB.sort();
+}
+
+bool PerimeterDBMaker::bfsAndStore()
+{
+    this->bfs();
+    perimeterDB.toFile(fileName);
+    return true;
+}
+
+const PerimeterDatabase& PerimeterDBMaker::getDatabase() const
+{
+    return perimeterDB;
+}
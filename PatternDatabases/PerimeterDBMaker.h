@@ -0,0 +1,21 @@
+#pragma once
+#include "PerimeterDatabase.h"
+#include "../Model/RubiksCubeBitboard.cpp"
+
+#ifndef PERIMETERDBMAKER_H
+#define PERIMETERDBMAKER_H
+
+class PerimeterDBMaker
+{
+    string fileName;
+    PerimeterDatabase perimeterDB;
+
+public:
+    explicit PerimeterDBMaker(const string& _fileName, uint8_t depth = 5);
+    // Fills the database in memory without writing it out.
+    void bfs();
+    bool bfsAndStore();
+    [[nodiscard]] const PerimeterDatabase& getDatabase() const;
+};
+
+#endif //PERIMETERDBMAKER_H
@@ -0,0 +1,135 @@
+#include "PerimeterDatabase.h"
+using namespace std;
+
+// Two key words, the number of moves and the solving move.
+constexpr size_t ENTRY_SIZE = 2 * sizeof(uint64_t) + 2 * sizeof(uint8_t);
+
+PerimeterDatabase::PerimeterDatabase() : depth(0)
+{
+}
+
+PerimeterDatabase::PerimeterDatabase(const uint8_t depth) : depth(depth)
+{
+}
+
+void PerimeterDatabase::add(const PackedCube& key, const uint8_t numMoves, const RubiksCube::MOVE solvingMove)
+{
+    this->entries.push_back({key, numMoves, static_cast<uint8_t>(solvingMove)});
+}
+
+void PerimeterDatabase::sort()
+{
+    ranges::sort(this->entries, {}, &Entry::key);
+}
+
+const PerimeterDatabase::Entry* PerimeterDatabase::find(const PackedCube& key) const
+{
+    if (this->entries.empty())
+    {
+        return nullptr;
+    }
+    const auto it = ranges::lower_bound(this->entries, key, {}, &Entry::key);
+    if (it == this->entries.end() || it->key != key)
+    {
+        return nullptr;
+    }
+    return &*it;
+}
+
+uint8_t PerimeterDatabase::getNumMoves(const RubiksCube& cube) const
+{
+    if (this->entries.empty())
+    {
+        return 0xFF;
+    }
+    return this->getNumMoves(PackedCube::pack(cube));
+}
+
+uint8_t PerimeterDatabase::getNumMoves(const PackedCube& key) const
+{
+    const Entry* entry = this->find(key);
+    return entry ? entry->numMoves : 0xFF;
+}
+
+RubiksCube::MOVE PerimeterDatabase::getSolvingMove(const RubiksCube& cube) const
+{
+    const Entry* entry = this->find(PackedCube::pack(cube));
+    if (!entry || entry->numMoves == 0)
+    {
+        throw invalid_argument("Cube has no solving move in the perimeter database");
+    }
+    return static_cast<RubiksCube::MOVE>(entry->solvingMove);
+}
+
+uint8_t PerimeterDatabase::getDepth() const
+{
+    return this->depth;
+}
+
+size_t PerimeterDatabase::getNumItems() const
+{
+    return this->entries.size();
+}
+
+bool PerimeterDatabase::isEmpty() const
+{
+    return this->entries.empty();
+}
+
+void PerimeterDatabase::toFile(const string& filePath) const
+{
+    vector<uint8_t> payload(this->entries.size() * ENTRY_SIZE);
+    uint8_t* out = payload.data();
+    for (const Entry& entry : this->entries)
+    {
+        memcpy(out, &entry.key.corners, sizeof(entry.key.corners));
+        memcpy(out + 8, &entry.key.edges, sizeof(entry.key.edges));
+        out[16] = entry.numMoves;
+        out[17] = entry.solvingMove;
+        out += ENTRY_SIZE;
+    }
+
+    DatabaseFileHeader header{};
+    header.kind = DATABASE_KIND::PERIMETER;
+    header.encoding = DATABASE_ENCODING::PACKED_SORTED_ENTRIES;
+    header.maxDepth = this->depth;
+    header.numEntries = this->entries.size();
+    header.numItems = this->entries.size();
+    header.depthLimit = this->depth;
+    writeDatabaseFile(filePath, header, payload.data(), payload.size());
+}
+
+bool PerimeterDatabase::fromFile(const string& filePath, const VERIFY_MODE mode)
+{
+    ifstream reader(filePath, ios::in | ios::binary | ios::ate);
+    if (!reader.is_open())
+    {
+        return false;
+    }
+    const size_t fileSize = reader.tellg();
+    reader.seekg(0, ios::beg);
+    const optional<DatabaseFileHeader> header = readDatabaseHeader(reader, fileSize);
+    if (!header || header->kind != DATABASE_KIND::PERIMETER ||
+        header->encoding != DATABASE_ENCODING::PACKED_SORTED_ENTRIES ||
+        header->payloadSize != header->numEntries * ENTRY_SIZE)
+    {
+        reader.close();
+        throw runtime_error("Perimeter database corrupt! Failed to open Reader");
+    }
+    vector<uint8_t> payload(header->payloadSize);
+    readDatabasePayload(reader, *header, payload.data(), mode);
+    reader.close();
+
+    this->depth = header->depthLimit;
+    this->entries.resize(header->numEntries);
+    const uint8_t* in = payload.data();
+    for (Entry& entry : this->entries)
+    {
+        memcpy(&entry.key.corners, in, sizeof(entry.key.corners));
+        memcpy(&entry.key.edges, in + 8, sizeof(entry.key.edges));
+        entry.numMoves = in[16];
+        entry.solvingMove = in[17];
+        in += ENTRY_SIZE;
+    }
+    return true;
+}
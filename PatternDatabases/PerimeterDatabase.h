@@ -0,0 +1,51 @@
+#pragma once
+#include "bits/stdc++.h"
+#include "../Model/RubiksCube.h"
+#include "../Model/PackedCube.h"
+#include "DatabaseFile.h"
+
+#ifndef PERIMETERDATABASE_H
+#define PERIMETERDATABASE_H
+
+// Exact distances and solving moves for every state within a few moves of the solved cube.
+class PerimeterDatabase
+{
+    struct Entry
+    {
+        PackedCube key;
+        uint8_t numMoves;
+        uint8_t solvingMove;
+    };
+
+    vector<Entry> entries;
+    uint8_t depth;
+
+    [[nodiscard]] const Entry* find(const PackedCube& key) const;
+
+public:
+    PerimeterDatabase();
+    explicit PerimeterDatabase(uint8_t depth);
+
+    void add(const PackedCube& key, uint8_t numMoves, RubiksCube::MOVE solvingMove);
+
+    void sort();
+
+    // Returns 0xFF when the cube lies outside the perimeter.
+    [[nodiscard]] uint8_t getNumMoves(const RubiksCube& cube) const;
+
+    [[nodiscard]] uint8_t getNumMoves(const PackedCube& key) const;
+
+    [[nodiscard]] RubiksCube::MOVE getSolvingMove(const RubiksCube& cube) const;
+
+    [[nodiscard]] uint8_t getDepth() const;
+
+    [[nodiscard]] size_t getNumItems() const;
+
+    [[nodiscard]] bool isEmpty() const;
+
+    void toFile(const string& filePath) const;
+
+    bool fromFile(const string& filePath, VERIFY_MODE mode = VERIFY_MODE::DEFAULT);
+};
+
+#endif //PERIMETERDATABASE_H
@@ -6,44 +6,57 @@ using namespace std;
 #ifndef PERMUTATIONINDEXER_H
 #define PERMUTATIONINDEXER_H
 
+// Ranks K-permutations of N elements in lexicographic order, eg- for N = K = 3,
+// {0, 1, 2} -> 0 and {2, 1, 0} -> 5. All tables are built at compile time.
 template <size_t N, size_t K = N>
 class PermutationIndexer
 {
-    array<uint32_t, (1 << N) - 1> onesCountLookup;
-    array<uint32_t, K> factorials;
+    // The largest rank, N! / (N - K)! - 1, has to fit in 32 bits.
+    static_assert(K <= N && N <= 12);
 
-public:
-    PermutationIndexer()
+    static constexpr array<uint32_t, K> factorials = []
     {
-        for (uint32_t i = 0; i < (1 << N) - 1; ++i)
+        array<uint32_t, K> result{};
+        for (uint32_t i = 0; i < K; ++i)
         {
-            bitset<N> bits(i);
-            this->onesCountLookup[i] = bits.count();
+            result[i] = pick(N - 1 - i, K - 1 - i);
         }
+        return result;
+    }();
+
+public:
+    [[nodiscard]] static constexpr uint32_t rank(const array<uint8_t, K>& perm)
+    {
+        uint32_t seen = 0;
+        uint32_t index = 0;
         for (uint32_t i = 0; i < K; ++i)
         {
-            this->factorials[i] = pick(N - 1 - i, K - 1 - i);
+            // The Lehmer digit is the element minus the smaller elements already used.
+            const uint32_t numSmallerSeen = popcount(seen & ((1u << perm[i]) - 1));
+            index += (perm[i] - numSmallerSeen) * factorials[i];
+            seen |= 1u << perm[i];
         }
+        return index;
     }
 
-    [[nodiscard]] uint32_t rank(const array<uint8_t, K>& perm) const
+    [[nodiscard]] static constexpr array<uint8_t, K> unrank(uint32_t index)
     {
-        array<uint32_t, K> lehmer;
-        bitset<N> seen;
-        lehmer[0] = perm[0];
-        seen[N - 1 - perm[0]] = 1;
-        for (uint32_t i = 1; i < K; ++i)
-        {
-            seen[N - 1 - perm[i]] = 1;
-            uint32_t numOnes = this->onesCountLookup[seen.to_ulong() >> (N - perm[i])];
-            lehmer[i] = perm[i] - numOnes;
-        }
-        uint32_t index = 0;
+        array<uint8_t, K> perm{};
+        uint32_t unused = (1u << N) - 1;
         for (uint32_t i = 0; i < K; ++i)
         {
-            index += lehmer[i] * this->factorials[i];
+            const uint32_t lehmer = index / factorials[i];
+            index %= factorials[i];
+            // Clear the lowest `lehmer` unused elements, the next one is the element to place.
+            uint32_t candidates = unused;
+            for (uint32_t j = 0; j < lehmer; ++j)
+            {
+                candidates &= candidates - 1;
+            }
+            perm[i] = countr_zero(candidates);
+            unused &= ~(1u << perm[i]);
         }
-        return index;
+        return perm;
     }
 };
 
@@ -0,0 +1,48 @@
+#include "RubiksCube2x2Database.h"
+
+RubiksCube2x2Database::RubiksCube2x2Database() : PatternDatabase(RubiksCube2x2::NUM_STATES)
+{
+}
+
+uint32_t RubiksCube2x2Database::getDatabaseIndex(const RubiksCube& cube) const
+{
+    return RubiksCube2x2::fromCube(cube).getIndex();
+}
+
+uint8_t RubiksCube2x2Database::getNumMoves(const RubiksCube2x2& cube) const
+{
+    return this->getNumMoves(cube.getIndex());
+}
+
+void RubiksCube2x2Database::generate()
+{
+    this->reset();
+    const RubiksCube2x2 solved;
+    vector<uint32_t> frontier = {solved.getIndex()};
+    this->setNumMoves(solved.getIndex(), 0);
+    uint8_t depth = 0;
+    while (!frontier.empty())
+    {
+        depth++;
+        vector<uint32_t> next;
+        for (const uint32_t index : frontier)
+        {
+            const RubiksCube2x2 node = RubiksCube2x2::fromIndex(index);
+            for (int generator = 0; generator < RubiksCube2x2::NUM_GENERATORS; ++generator)
+            {
+                const uint32_t childIndex = node.getChild(generator).getIndex();
+                if (this->setNumMoves(childIndex, depth))
+                {
+                    next.push_back(childIndex);
+                }
+            }
+        }
+        frontier = std::move(next);
+    }
+    this->setDepthLimit(depth - 1);
+}
+
+DATABASE_KIND RubiksCube2x2Database::getKind() const
+{
+    return DATABASE_KIND::POCKET_CUBE;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "../Model/RubiksCube2x2.cpp"
+#include "PatternDatabase.h"
+
+#ifndef RUBIKSCUBE2X2DATABASE_H
+#define RUBIKSCUBE2X2DATABASE_H
+
+// Exact distances for all 3674160 states of the pocket cube, indexed by RubiksCube2x2::getIndex.
+class RubiksCube2x2Database : public PatternDatabase
+{
+public:
+    RubiksCube2x2Database();
+
+    // Only 3x3 cubes with the down-back-left corner solved map onto the table.
+    [[nodiscard]] uint32_t getDatabaseIndex(const RubiksCube& cube) const override;
+
+    using PatternDatabase::getNumMoves;
+
+    [[nodiscard]] uint8_t getNumMoves(const RubiksCube2x2& cube) const;
+
+    // Fills the table with a breadth-first search from the solved cube.
+    void generate();
+
+    [[nodiscard]] DATABASE_KIND getKind() const override;
+};
+
+#endif //RUBIKSCUBE2X2DATABASE_H
@@ -0,0 +1,226 @@
+#include "StorageBuffer.h"
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+namespace
+{
+    constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+#ifdef __linux__
+    constexpr int MPOL_INTERLEAVE = 3;
+
+    // Returns a bit mask of the online NUMA nodes, parsed from eg- "0-1,3".
+    vector<unsigned long> getOnlineNumaNodes()
+    {
+        ifstream reader("/sys/devices/system/node/online");
+        string ranges;
+        if (!reader.is_open() || !getline(reader, ranges))
+        {
+            return {};
+        }
+        vector<unsigned long> mask;
+        stringstream stream(ranges);
+        string range;
+        while (getline(stream, range, ','))
+        {
+            const size_t dash = range.find('-');
+            const unsigned long first = stoul(range.substr(0, dash));
+            const unsigned long last = dash == string::npos ? first : stoul(range.substr(dash + 1));
+            for (unsigned long node = first; node <= last; ++node)
+            {
+                const size_t word = node / (8 * sizeof(unsigned long));
+                if (mask.size() <= word)
+                {
+                    mask.resize(word + 1, 0);
+                }
+                mask[word] |= 1ul << (node % (8 * sizeof(unsigned long)));
+            }
+        }
+        return mask;
+    }
+
+    bool interleaveAcrossNumaNodes(void* addr, const size_t len)
+    {
+        const vector<unsigned long> nodes = getOnlineNumaNodes();
+        size_t numNodes = 0;
+        for (const unsigned long word : nodes)
+        {
+            numNodes += popcount(word);
+        }
+        if (numNodes < 2)
+        {
+            return false;
+        }
+        const unsigned long maxNode = nodes.size() * 8 * sizeof(unsigned long) + 1;
+        return syscall(SYS_mbind, addr, len, MPOL_INTERLEAVE, nodes.data(), maxNode, 0) == 0;
+    }
+
+    // Maps len bytes aligned to a huge page boundary, so transparent huge pages can back all of it.
+    void* mapHugePageAligned(const size_t len)
+    {
+        void* raw = mmap(nullptr, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        const auto start = reinterpret_cast<uintptr_t>(raw);
+        const uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+        if (aligned != start)
+        {
+            munmap(raw, aligned - start);
+        }
+        if (const size_t tail = start + len + HUGE_PAGE_SIZE - (aligned + len); tail != 0)
+        {
+            munmap(reinterpret_cast<void*>(aligned + len), tail);
+        }
+        return reinterpret_cast<void*>(aligned);
+    }
+#endif
+}
+
+StorageBuffer::StorageBuffer(const size_t size, const uint8_t val, const StoragePlacement placement) :
+    buffer(nullptr), bufferSize(size), mappedSize(0), backing(BACKING::HEAP), numaInterleaved(false)
+{
+#ifdef __linux__
+    // A table smaller than one huge page would waste most of it, and hugetlbfs pages are a scarce reserve.
+    const bool mapped = size >= HUGE_PAGE_SIZE;
+    const size_t len = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    if (mapped && placement.hugePages)
+    {
+        void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr != MAP_FAILED)
+        {
+            this->buffer = static_cast<uint8_t*>(addr);
+            this->backing = BACKING::HUGETLB;
+        }
+    }
+    if (mapped && !this->buffer && (placement.hugePages || placement.numaInterleave))
+    {
+        if (void* addr = mapHugePageAligned(len))
+        {
+            this->buffer = static_cast<uint8_t*>(addr);
+            this->backing = BACKING::PAGES;
+            if (placement.hugePages && madvise(addr, len, MADV_HUGEPAGE) == 0)
+            {
+                this->backing = BACKING::TRANSPARENT_HUGE_PAGES;
+            }
+        }
+    }
+    if (this->buffer)
+    {
+        this->mappedSize = len;
+        // The policy has to be in place before the pages are first touched.
+        if (placement.numaInterleave)
+        {
+            this->numaInterleaved = interleaveAcrossNumaNodes(this->buffer, len);
+        }
+    }
+#endif
+    if (!this->buffer)
+    {
+        this->buffer = static_cast<uint8_t*>(::operator new(max<size_t>(size, 1), align_val_t(CACHE_LINE_SIZE)));
+        this->backing = BACKING::HEAP;
+    }
+    memset(this->buffer, val, size);
+}
+
+StorageBuffer::StorageBuffer(StorageBuffer&& other) noexcept :
+    buffer(other.buffer), bufferSize(other.bufferSize), mappedSize(other.mappedSize), backing(other.backing),
+    numaInterleaved(other.numaInterleaved)
+{
+    other.buffer = nullptr;
+    other.bufferSize = 0;
+    other.mappedSize = 0;
+}
+
+StorageBuffer& StorageBuffer::operator=(StorageBuffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        this->release();
+        this->buffer = other.buffer;
+        this->bufferSize = other.bufferSize;
+        this->mappedSize = other.mappedSize;
+        this->backing = other.backing;
+        this->numaInterleaved = other.numaInterleaved;
+        other.buffer = nullptr;
+        other.bufferSize = 0;
+        other.mappedSize = 0;
+    }
+    return *this;
+}
+
+StorageBuffer::~StorageBuffer()
+{
+    this->release();
+}
+
+void StorageBuffer::release()
+{
+    if (!this->buffer)
+    {
+        return;
+    }
+#ifdef __linux__
+    if (this->mappedSize != 0)
+    {
+        munmap(this->buffer, this->mappedSize);
+        this->buffer = nullptr;
+        return;
+    }
+#endif
+    ::operator delete(this->buffer, align_val_t(CACHE_LINE_SIZE));
+    this->buffer = nullptr;
+}
+
+uint8_t* StorageBuffer::data()
+{
+    return this->buffer;
+}
+
+const uint8_t* StorageBuffer::data() const
+{
+    return this->buffer;
+}
+
+size_t StorageBuffer::size() const
+{
+    return this->bufferSize;
+}
+
+StorageBuffer::BACKING StorageBuffer::getBacking() const
+{
+    return this->backing;
+}
+
+bool StorageBuffer::isNumaInterleaved() const
+{
+    return this->numaInterleaved;
+}
+
+string StorageBuffer::describe() const
+{
+    string description = getBackingName(this->backing);
+    if (this->numaInterleaved)
+    {
+        description += "+numa-interleave";
+    }
+    return description;
+}
+
+string StorageBuffer::getBackingName(const BACKING backing)
+{
+    switch (backing)
+    {
+    case BACKING::HEAP: return "heap";
+    case BACKING::PAGES: return "pages";
+    case BACKING::TRANSPARENT_HUGE_PAGES: return "thp";
+    case BACKING::HUGETLB: return "hugetlb";
+    default: return "?";
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <bits/stdc++.h>
+using namespace std;
+
+#ifndef STORAGEBUFFER_H
+#define STORAGEBUFFER_H
+
+struct StoragePlacement
+{
+    // Back the buffer with 2 MiB pages (MAP_HUGETLB, then transparent huge pages), falling back to 4 KiB pages.
+    // Buffers smaller than one huge page always come from the heap.
+    bool hugePages = true;
+    // Spread the pages round-robin over every NUMA node, so no single socket serves all lookups.
+    bool numaInterleave = false;
+};
+
+// Raw byte storage for pattern databases. Large tables are read at random, so
+// the pages backing them matter: huge pages avoid a TLB miss on nearly every lookup.
+class StorageBuffer
+{
+public:
+    enum class BACKING
+    {
+        HEAP,
+        PAGES,
+        TRANSPARENT_HUGE_PAGES,
+        HUGETLB
+    };
+
+private:
+    uint8_t* buffer;
+    size_t bufferSize;
+    size_t mappedSize;
+    BACKING backing;
+    bool numaInterleaved;
+
+    void release();
+
+public:
+    StorageBuffer(size_t size, uint8_t val, StoragePlacement placement = {});
+    StorageBuffer(const StorageBuffer&) = delete;
+    StorageBuffer& operator=(const StorageBuffer&) = delete;
+    StorageBuffer(StorageBuffer&& other) noexcept;
+    StorageBuffer& operator=(StorageBuffer&& other) noexcept;
+    ~StorageBuffer();
+
+    uint8_t* data();
+
+    [[nodiscard]] const uint8_t* data() const;
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] BACKING getBacking() const;
+
+    [[nodiscard]] bool isNumaInterleaved() const;
+
+    // eg- "hugetlb", "thp+numa-interleave"
+    [[nodiscard]] string describe() const;
+
+    static string getBackingName(BACKING backing);
+};
+
+#endif //STORAGEBUFFER_H
@@ -0,0 +1,81 @@
+#pragma once
+#include<bits/stdc++.h>
+using namespace std;
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+/*
+ * A blocking FIFO with a fixed capacity, shared by producer and consumer threads.
+ * Producers wait while it is full, which pushes back on whatever feeds them.
+ */
+template <typename T>
+class BoundedQueue
+{
+    queue<T> items;
+    size_t capacity;
+    bool closed = false;
+    mutable mutex lock;
+    condition_variable notFull;
+    condition_variable notEmpty;
+
+public:
+    explicit BoundedQueue(const size_t _capacity) : capacity(max<size_t>(1, _capacity))
+    {
+    }
+
+    /**
+     * Adds an item, waiting for room if the queue is full.
+     *
+     * @param item the item to add
+     * @return false if the queue was closed, in which case the item is dropped
+     */
+    bool push(T item)
+    {
+        unique_lock guard(lock);
+        notFull.wait(guard, [this] { return closed || items.size() < capacity; });
+        if (closed)
+        {
+            return false;
+        }
+        items.push(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * Removes the oldest item, waiting for one if the queue is empty.
+     *
+     * @return the item, or nullopt once the queue is closed and drained
+     */
+    optional<T> pop()
+    {
+        unique_lock guard(lock);
+        notEmpty.wait(guard, [this] { return closed || !items.empty(); });
+        if (items.empty())
+        {
+            return nullopt;
+        }
+        T item = std::move(items.front());
+        items.pop();
+        notFull.notify_one();
+        return item;
+    }
+
+    // Wakes every waiting thread. Items already queued can still be popped.
+    void close()
+    {
+        lock_guard guard(lock);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        lock_guard guard(lock);
+        return items.size();
+    }
+};
+
+#endif //BOUNDEDQUEUE_H
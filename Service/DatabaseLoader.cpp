@@ -0,0 +1,74 @@
+#include "DatabaseLoader.h"
+#include "../PatternDatabases/DatabaseRegistry.h"
+using namespace std;
+
+DatabaseLoader::DatabaseLoader(shared_ptr<DatabaseSlot<CornerPatternDatabase>> _slot, string _fileName,
+                               const VERIFY_MODE _mode, function<void(const DatabaseLoader&)> _onFinished)
+    : slot(std::move(_slot)), fileName(std::move(_fileName)), mode(_mode), onFinished(std::move(_onFinished))
+{
+    worker = thread(&DatabaseLoader::load, this);
+}
+
+DatabaseLoader::~DatabaseLoader()
+{
+    worker.join();
+}
+
+void DatabaseLoader::load()
+{
+    const auto start_time = chrono::steady_clock::now();
+    try
+    {
+        const shared_ptr<const CornerPatternDatabase> corners =
+            DatabaseRegistry::global().acquire<CornerPatternDatabase>(fileName, mode);
+        if (!corners)
+        {
+            throw runtime_error("Cannot open corner database " + fileName);
+        }
+        loadSeconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        slot->set(corners);
+        state = LOAD_STATE::LOADED;
+    }
+    catch (const exception& e)
+    {
+        error = e.what();
+        state = LOAD_STATE::FAILED;
+    }
+    state.notify_all();
+    if (onFinished)
+    {
+        onFinished(*this);
+    }
+}
+
+LOAD_STATE DatabaseLoader::wait()
+{
+    state.wait(LOAD_STATE::LOADING);
+    return state;
+}
+
+LOAD_STATE DatabaseLoader::getState() const
+{
+    return state;
+}
+
+string DatabaseLoader::getError() const
+{
+    return state == LOAD_STATE::FAILED ? error : "";
+}
+
+double DatabaseLoader::getLoadSeconds() const
+{
+    return state == LOAD_STATE::LOADED ? loadSeconds : 0;
+}
+
+string DatabaseLoader::getStateName(const LOAD_STATE state)
+{
+    switch (state)
+    {
+    case LOAD_STATE::LOADING: return "loading";
+    case LOAD_STATE::LOADED: return "loaded";
+    case LOAD_STATE::FAILED: return "failed";
+    default: return "?";
+    }
+}
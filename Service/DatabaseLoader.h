@@ -0,0 +1,61 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "../PatternDatabases/CornerPatternDatabase.h"
+#include "../PatternDatabases/DatabaseSlot.h"
+
+#ifndef DATABASELOADER_H
+#define DATABASELOADER_H
+
+enum class LOAD_STATE
+{
+    LOADING,
+    LOADED,
+    FAILED
+};
+
+/*
+ * Loads a corner database on a thread of its own and puts it in a slot once it
+ * has been read and verified, so solvers can start on a weaker heuristic instead
+ * of waiting for the file. A file that fails to load leaves the slot as it was.
+ */
+class DatabaseLoader
+{
+    shared_ptr<DatabaseSlot<CornerPatternDatabase>> slot;
+    string fileName;
+    VERIFY_MODE mode;
+    // error and loadSeconds are written before the state leaves LOADING, and only read after.
+    atomic<LOAD_STATE> state{LOAD_STATE::LOADING};
+    string error;
+    double loadSeconds = 0;
+    function<void(const DatabaseLoader&)> onFinished;
+    thread worker;
+
+    void load();
+
+public:
+    // onFinished is called on the loading thread once the state has left LOADING, eg- to log it.
+    DatabaseLoader(shared_ptr<DatabaseSlot<CornerPatternDatabase>> _slot, string _fileName,
+                   VERIFY_MODE _mode = VERIFY_MODE::DEFAULT,
+                   function<void(const DatabaseLoader&)> _onFinished = nullptr);
+
+    // Waits for the load to finish, a database cannot be abandoned halfway through reading it.
+    ~DatabaseLoader();
+
+    DatabaseLoader(const DatabaseLoader&) = delete;
+    DatabaseLoader& operator=(const DatabaseLoader&) = delete;
+
+    // Blocks until the database is in the slot or has failed to load.
+    LOAD_STATE wait();
+
+    [[nodiscard]] LOAD_STATE getState() const;
+
+    // Why the load failed, empty unless the state is FAILED.
+    [[nodiscard]] string getError() const;
+
+    // How long reading and verifying the file took, 0 until it is loaded.
+    [[nodiscard]] double getLoadSeconds() const;
+
+    static string getStateName(LOAD_STATE state);
+};
+
+#endif //DATABASELOADER_H
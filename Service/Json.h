@@ -0,0 +1,37 @@
+#pragma once
+#include<bits/stdc++.h>
+using namespace std;
+
+#ifndef JSON_H
+#define JSON_H
+
+// Quotes and escapes text as a JSON string literal.
+inline string toJsonString(const string_view text)
+{
+    string result = "\"";
+    for (const char c : text)
+    {
+        switch (c)
+        {
+        case '"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[7];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                result += escaped;
+            }
+            else
+            {
+                result += c;
+            }
+        }
+    }
+    return result + "\"";
+}
+
+#endif //JSON_H
@@ -0,0 +1,127 @@
+#include "Protocol.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+namespace
+{
+    // Returns the number of bytes read, short only at the end of the stream.
+    size_t readFully(const int fd, char* dest, const size_t size)
+    {
+        size_t done = 0;
+        while (done < size)
+        {
+            const ssize_t n = read(fd, dest + done, size - done);
+            if (n == 0) break;
+            if (n < 0)
+            {
+                if (errno == EINTR) continue;
+                throw runtime_error(string("Socket read failed: ") + strerror(errno));
+            }
+            done += n;
+        }
+        return done;
+    }
+
+    sockaddr_un getAddress(const string& path)
+    {
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw invalid_argument("Socket path is too long: " + path);
+        }
+        address.sun_family = AF_UNIX;
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
+}
+
+bool readFrame(const int fd, string& payload)
+{
+    array<uint8_t, 4> header{};
+    const size_t headerRead = readFully(fd, reinterpret_cast<char*>(header.data()), header.size());
+    if (headerRead == 0)
+    {
+        return false;
+    }
+    if (headerRead != header.size())
+    {
+        throw runtime_error("Connection closed inside a frame header");
+    }
+    const uint32_t size = header[0] | header[1] << 8 | header[2] << 16 | static_cast<uint32_t>(header[3]) << 24;
+    if (size > MAX_FRAME_SIZE)
+    {
+        throw runtime_error("Frame of " + to_string(size) + " bytes is over the limit");
+    }
+    payload.resize(size);
+    if (readFully(fd, payload.data(), size) != size)
+    {
+        throw runtime_error("Connection closed inside a frame");
+    }
+    return true;
+}
+
+void writeFrame(const int fd, const string_view payload)
+{
+    if (payload.size() > MAX_FRAME_SIZE)
+    {
+        throw runtime_error("Frame of " + to_string(payload.size()) + " bytes is over the limit");
+    }
+    const auto size = static_cast<uint32_t>(payload.size());
+    string frame = {
+        static_cast<char>(size & 0xFF), static_cast<char>(size >> 8 & 0xFF),
+        static_cast<char>(size >> 16 & 0xFF), static_cast<char>(size >> 24 & 0xFF)
+    };
+    frame += payload;
+    size_t done = 0;
+    while (done < frame.size())
+    {
+        // MSG_NOSIGNAL turns a vanished peer into an error instead of a SIGPIPE.
+        const ssize_t n = send(fd, frame.data() + done, frame.size() - done, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            throw runtime_error(string("Socket write failed: ") + strerror(errno));
+        }
+        done += n;
+    }
+}
+
+int listenUnixSocket(const string& path)
+{
+    const sockaddr_un address = getAddress(path);
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        throw runtime_error(string("Cannot create socket: ") + strerror(errno));
+    }
+    if (error_code ec; filesystem::is_socket(path, ec))
+    {
+        unlink(path.c_str());
+    }
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0)
+    {
+        const string error = strerror(errno);
+        close(fd);
+        throw runtime_error("Cannot listen on " + path + ": " + error);
+    }
+    return fd;
+}
+
+int connectUnixSocket(const string& path)
+{
+    const sockaddr_un address = getAddress(path);
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        throw runtime_error(string("Cannot create socket: ") + strerror(errno));
+    }
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        const string error = strerror(errno);
+        close(fd);
+        throw runtime_error("Cannot connect to " + path + ": " + error);
+    }
+    return fd;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include<bits/stdc++.h>
+using namespace std;
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+/*
+ * Solver daemon wire format over a Unix domain stream socket.
+ *
+ * Every message is a frame: a little-endian uint32 payload length, then the payload.
+ * Requests are text, responses are a single JSON object:
+ *
+ *   SOLVE <id> <engine> <deadline-ms> <moves...>   deadline-ms 0 means no deadline
+ *   METRICS
+ *
+ * Solve responses carry the request id. Requests on one connection may be
+ * pipelined, and their responses come back in completion order.
+ */
+constexpr uint32_t MAX_FRAME_SIZE = 1 << 20;
+
+// Returns false on a clean end of stream before a frame, throws runtime_error on a broken one.
+bool readFrame(int fd, string& payload);
+
+void writeFrame(int fd, string_view payload);
+
+// Binds and listens on path, replacing a stale socket file left behind at it.
+int listenUnixSocket(const string& path);
+
+int connectUnixSocket(const string& path);
+
+#endif //PROTOCOL_H
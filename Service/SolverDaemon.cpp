@@ -0,0 +1,242 @@
+#include "SolverDaemon.h"
+#include "Json.h"
+#include "Protocol.h"
+#include "../PatternDatabases/DatabaseRegistry.h"
+#include <sys/socket.h>
+#include <unistd.h>
+using namespace std;
+
+SolverDaemon::Connection::Connection(const int _fd) : fd(_fd)
+{
+}
+
+SolverDaemon::Connection::~Connection()
+{
+    close(fd);
+}
+
+SolverDaemon::SolverDaemon(const SolverEngine& _engine, const unsigned _numThreads, const size_t queueCapacity)
+    : engine(_engine), numThreads(max(1u, _numThreads)), requests(queueCapacity),
+      startTime(chrono::steady_clock::now())
+{
+    latencies.reserve(LATENCY_WINDOW);
+}
+
+void SolverDaemon::respond(Connection& connection, const string& response) const
+{
+    lock_guard guard(connection.writeLock);
+    try
+    {
+        writeFrame(connection.fd, response);
+    }
+    catch (const exception&)
+    {
+        // The client has gone away, there is no one left to tell.
+    }
+}
+
+void SolverDaemon::recordLatency(const double milliseconds)
+{
+    if (latencies.size() < LATENCY_WINDOW)
+    {
+        latencies.push_back(milliseconds);
+    }
+    else
+    {
+        latencies[nextLatency] = milliseconds;
+    }
+    nextLatency = (nextLatency + 1) % LATENCY_WINDOW;
+}
+
+void SolverDaemon::readRequests(const shared_ptr<Connection>& connection)
+{
+    string payload;
+    try
+    {
+        while (readFrame(connection->fd, payload))
+        {
+            istringstream stream(payload);
+            string command;
+            stream >> command;
+            if (command == "METRICS")
+            {
+                // Answered right away, so metrics stay readable while the workers are saturated.
+                this->respond(*connection, this->getMetrics());
+                continue;
+            }
+            Request request;
+            request.connection = connection;
+            request.received = chrono::steady_clock::now();
+            try
+            {
+                string engineName;
+                int64_t deadlineMs = -1;
+                if (command != "SOLVE" || !(stream >> request.id >> engineName >> deadlineMs) || deadlineMs < 0)
+                {
+                    throw invalid_argument("Expected SOLVE <id> <engine> <deadline-ms> <moves...> or METRICS");
+                }
+                request.engine = SolverEngine::parseEngine(engineName);
+                if (deadlineMs > 0)
+                {
+                    request.deadline = request.received + chrono::milliseconds(deadlineMs);
+                }
+                string moves;
+                getline(stream, moves);
+                request.scramble = RubiksCube::parseMoves(moves);
+            }
+            catch (const exception& e)
+            {
+                string response = "{";
+                if (!request.id.empty())
+                {
+                    response += "\"id\":" + toJsonString(request.id) + ",";
+                }
+                this->respond(*connection, response + "\"error\":" + toJsonString(e.what()) + "}");
+                lock_guard guard(metricsLock);
+                ++numFailed;
+                continue;
+            }
+            {
+                lock_guard guard(metricsLock);
+                ++numReceived;
+            }
+            if (!requests.push(std::move(request)))
+            {
+                break;
+            }
+        }
+    }
+    catch (const exception&)
+    {
+        // A broken frame leaves the stream out of sync, so the connection is dropped.
+    }
+}
+
+void SolverDaemon::processRequests()
+{
+    while (const optional<Request> request = requests.pop())
+    {
+        {
+            lock_guard guard(metricsLock);
+            ++numInFlight;
+        }
+        string response = "{\"id\":" + toJsonString(request->id) + ",";
+        SolveResult result;
+        bool failed = false;
+        try
+        {
+            result = engine.solve(request->scramble, request->engine, request->deadline);
+            response += SolverEngine::toJsonMembers(result, request->engine);
+        }
+        catch (const exception& e)
+        {
+            failed = true;
+            response += "\"error\":" + toJsonString(e.what());
+        }
+        const double latencyMs =
+            chrono::duration<double, milli>(chrono::steady_clock::now() - request->received).count();
+        ostringstream latency;
+        latency << ",\"latencyMs\":" << latencyMs << "}";
+        this->respond(*request->connection, response + latency.str());
+
+        lock_guard guard(metricsLock);
+        --numInFlight;
+        ++(failed ? numFailed : numCompleted);
+        numTimedOut += result.timedOut;
+        if (result.nodesExpanded)
+        {
+            totalNodes += *result.nodesExpanded;
+            totalSearchSeconds += result.elapsedSeconds;
+        }
+        this->recordLatency(latencyMs);
+    }
+}
+
+void SolverDaemon::serve(const string& socketPath)
+{
+    listenFd = listenUnixSocket(socketPath);
+    vector<thread> workers;
+    for (unsigned t = 0; t < numThreads; ++t)
+    {
+        workers.emplace_back(&SolverDaemon::processRequests, this);
+    }
+
+    while (!stopping)
+    {
+        const int fd = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+        const auto connection = make_shared<Connection>(fd);
+        {
+            lock_guard guard(connectionsLock);
+            connections.emplace(connection.get(), connection);
+        }
+        thread([this, connection]
+        {
+            this->readRequests(connection);
+            lock_guard guard(connectionsLock);
+            connections.erase(connection.get());
+            readersDone.notify_all();
+        }).detach();
+    }
+
+    // Stop reading new requests, then let the workers finish the ones already queued.
+    {
+        unique_lock guard(connectionsLock);
+        for (const auto& [_, weakConnection] : connections)
+        {
+            if (const shared_ptr<Connection> connection = weakConnection.lock())
+            {
+                shutdown(connection->fd, SHUT_RD);
+            }
+        }
+        readersDone.wait(guard, [this] { return connections.empty(); });
+    }
+    requests.close();
+    for (thread& worker : workers)
+    {
+        worker.join();
+    }
+    close(listenFd.exchange(-1));
+    unlink(socketPath.c_str());
+}
+
+void SolverDaemon::stop()
+{
+    stopping = true;
+    if (const int fd = listenFd; fd >= 0)
+    {
+        shutdown(fd, SHUT_RDWR);
+    }
+}
+
+string SolverDaemon::getMetrics() const
+{
+    vector<double> window;
+    ostringstream out;
+    {
+        lock_guard guard(metricsLock);
+        window = latencies;
+        out << "{\"uptimeSeconds\":" << chrono::duration<double>(chrono::steady_clock::now() - startTime).count()
+            << ",\"queueDepth\":" << requests.size()
+            << ",\"inFlight\":" << numInFlight
+            << ",\"received\":" << numReceived
+            << ",\"completed\":" << numCompleted
+            << ",\"failed\":" << numFailed
+            << ",\"timedOut\":" << numTimedOut
+            << ",\"cornerDatabaseLoaded\":" << (engine.isCornerDatabaseLoaded() ? "true" : "false")
+            << ",\"databasesLoaded\":" << DatabaseRegistry::global().getNumLoaded()
+            << ",\"nodesPerSecond\":" << (totalSearchSeconds > 0 ? totalNodes / totalSearchSeconds : 0);
+    }
+    ranges::sort(window);
+    const auto percentile = [&](const double p)
+    {
+        return window.empty() ? 0 : window[min(window.size() - 1, static_cast<size_t>(p * window.size()))];
+    };
+    out << ",\"latencyMs\":{\"p50\":" << percentile(0.5) << ",\"p90\":" << percentile(0.9)
+        << ",\"p99\":" << percentile(0.99) << ",\"max\":" << (window.empty() ? 0 : window.back()) << "}}";
+    return out.str();
+}
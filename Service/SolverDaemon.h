@@ -0,0 +1,84 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "BoundedQueue.h"
+#include "SolverEngine.h"
+
+#ifndef SOLVERDAEMON_H
+#define SOLVERDAEMON_H
+
+/*
+ * Serves solve requests over a Unix domain socket with the databases kept loaded.
+ *
+ * Each connection has a reader thread that parses frames and queues solves
+ * for a fixed pool of workers. When the queue is full the readers block, which
+ * pushes back on clients through their sockets. See Protocol.h for the format.
+ */
+class SolverDaemon
+{
+    struct Connection
+    {
+        int fd;
+        mutex writeLock;
+
+        explicit Connection(int _fd);
+        ~Connection();
+    };
+
+    struct Request
+    {
+        shared_ptr<Connection> connection;
+        string id;
+        ENGINE engine;
+        vector<RubiksCube::MOVE> scramble;
+        chrono::steady_clock::time_point received;
+        optional<chrono::steady_clock::time_point> deadline;
+    };
+
+    // Latency percentiles are taken over this many of the latest responses.
+    static constexpr size_t LATENCY_WINDOW = 4096;
+
+    const SolverEngine& engine;
+    unsigned numThreads;
+    BoundedQueue<Request> requests;
+    chrono::steady_clock::time_point startTime;
+    atomic<int> listenFd{-1};
+    atomic<bool> stopping{false};
+
+    // Connections with a running reader, so stop() can wake them.
+    mutex connectionsLock;
+    condition_variable readersDone;
+    unordered_map<Connection*, weak_ptr<Connection>> connections;
+
+    mutable mutex metricsLock;
+    uint64_t numReceived = 0;
+    uint64_t numCompleted = 0;
+    uint64_t numFailed = 0;
+    uint64_t numTimedOut = 0;
+    uint64_t numInFlight = 0;
+    uint64_t totalNodes = 0;
+    double totalSearchSeconds = 0;
+    vector<double> latencies;
+    size_t nextLatency = 0;
+
+    void readRequests(const shared_ptr<Connection>& connection);
+
+    void processRequests();
+
+    void respond(Connection& connection, const string& response) const;
+
+    void recordLatency(double milliseconds);
+
+public:
+    SolverDaemon(const SolverEngine& _engine, unsigned _numThreads, size_t queueCapacity);
+
+    // Serves until stop() is called, then finishes the queued requests and returns.
+    void serve(const string& socketPath);
+
+    // Async-signal-safe, so it can be called from a SIGINT or SIGTERM handler.
+    void stop();
+
+    // Queue depth, request counts, latency percentiles in milliseconds and search nodes per second, as JSON.
+    [[nodiscard]] string getMetrics() const;
+};
+
+#endif //SOLVERDAEMON_H
@@ -0,0 +1,241 @@
+#include "SolverEngine.h"
+#include "Json.h"
+#include "../Model/RubiksCubeBitboard.cpp"
+#include "../Solver/BFSSolver.h"
+#include "../Solver/IDDFSSolver.h"
+#include "../Solver/IDASTARSolver.h"
+using namespace std;
+
+SolverEngine::SolverEngine(shared_ptr<const DatabaseSlot<CornerPatternDatabase>> _cornerSlot,
+                           shared_ptr<const PerimeterDatabase> _perimeterDB, const int _iddfsMaxDepth,
+                           shared_ptr<const SolutionOptimizer> _optimizer, const unsigned _bfsThreads,
+                           const size_t _transpositionBytes, const uint64_t _nodeBudget,
+                           shared_ptr<const RubiksCube2x2Solver> _pocketSolver, const SearchTuning _tuning)
+    : cornerSlot(std::move(_cornerSlot)), perimeterDB(std::move(_perimeterDB)), iddfsMaxDepth(_iddfsMaxDepth),
+      optimizer(std::move(_optimizer)), bfsThreads(_bfsThreads), transpositionBytes(_transpositionBytes),
+      nodeBudget(_nodeBudget), pocketSolver(std::move(_pocketSolver)), tuning(_tuning)
+{
+    if (!this->perimeterDB)
+    {
+        this->perimeterDB = make_shared<const PerimeterDatabase>();
+    }
+}
+
+shared_ptr<const EffortPredictor> SolverEngine::getPredictor(
+    const shared_ptr<const CornerPatternDatabase>& cornerDB) const
+{
+    lock_guard guard(predictorLock);
+    if (!this->predictor || this->predictor->getDatabase() != cornerDB)
+    {
+        this->predictor = make_shared<const EffortPredictor>(cornerDB, this->nodeBudget);
+    }
+    return this->predictor;
+}
+
+bool SolverEngine::isCornerDatabaseLoaded() const
+{
+    return this->cornerSlot && this->cornerSlot->get();
+}
+
+ENGINE SolverEngine::parseEngine(const string& name)
+{
+    if (name == "bfs") return ENGINE::BFS;
+    if (name == "iddfs") return ENGINE::IDDFS;
+    if (name == "idastar") return ENGINE::IDASTAR;
+    if (name == "auto") return ENGINE::AUTO;
+    if (name == "pocket") return ENGINE::POCKET;
+    throw invalid_argument("Unknown engine \"" + name + "\", expected bfs, iddfs, idastar, auto or pocket");
+}
+
+string SolverEngine::getEngineName(const ENGINE engine)
+{
+    switch (engine)
+    {
+    case ENGINE::BFS: return "bfs";
+    case ENGINE::IDDFS: return "iddfs";
+    case ENGINE::IDASTAR: return "idastar";
+    case ENGINE::AUTO: return "auto";
+    case ENGINE::POCKET: return "pocket";
+    default: return "?";
+    }
+}
+
+SolveResult SolverEngine::solve(const vector<RubiksCube::MOVE>& scramble, const ENGINE engine,
+                                const optional<chrono::steady_clock::time_point> deadline) const
+{
+    RubiksCubeBitboard cube;
+    for (const RubiksCube::MOVE move : scramble)
+    {
+        cube.move(move);
+    }
+    SolveResult result;
+    const auto start_time = chrono::steady_clock::now();
+    if (deadline && start_time >= *deadline)
+    {
+        result.timedOut = true;
+        return result;
+    }
+    const auto solveIDAstar = [&]
+    {
+        if (!this->cornerSlot)
+        {
+            throw invalid_argument("The idastar engine needs a corner pattern database");
+        }
+        IDAstarSolver<RubiksCubeBitboard> solver(cube, this->cornerSlot, this->perimeterDB);
+        solver.setDualLookups(this->tuning.dualLookups);
+        solver.setBatchedLookups(this->tuning.batchedLookups);
+        solver.setChildOrdering(this->tuning.orderByEstimate, this->tuning.useHistory);
+        if (deadline)
+        {
+            solver.setDeadline(*deadline);
+        }
+        result.moves = solver.solve();
+        result.solved = solver.rubiksCube.isSolved();
+        result.timedOut = solver.getStatistics().timedOut;
+        result.nodesExpanded = solver.getStatistics().nodesExpanded;
+        result.lastIterationNodes = solver.getStatistics().lastIterationNodes;
+        result.heuristicLookups = solver.getStatistics().heuristicLookups;
+    };
+    switch (engine)
+    {
+    case ENGINE::BFS:
+        {
+            BFSSolver<RubiksCubeBitboard> solver(cube, this->bfsThreads);
+            result.moves = solver.solve();
+            result.solved = solver.rubiksCube.isSolved();
+            break;
+        }
+    case ENGINE::IDDFS:
+        {
+            unique_ptr<TranspositionTable> table;
+            if (this->transpositionBytes > 0)
+            {
+                table = make_unique<TranspositionTable>(this->transpositionBytes);
+            }
+            IDDFSSolver<RubiksCubeBitboard> solver(cube, this->iddfsMaxDepth, table.get());
+            result.moves = solver.solve();
+            result.solved = solver.rubiksCube.isSolved();
+            if (table)
+            {
+                result.transposition = table->getStatistics();
+            }
+            break;
+        }
+    case ENGINE::IDASTAR:
+        solveIDAstar();
+        break;
+    case ENGINE::AUTO:
+        {
+            if (!this->cornerSlot)
+            {
+                throw invalid_argument("The auto engine needs a corner pattern database");
+            }
+            // The scramble undone is a solution, so the solution is at most as long as the scramble.
+            vector<RubiksCube::MOVE> undo;
+            for (auto it = scramble.rbegin(); it != scramble.rend(); ++it)
+            {
+                undo.push_back(RubiksCube::getInverseMove(*it));
+            }
+            undo = SolutionOptimizer::cancelMoves(undo);
+            // Nothing can be predicted until the corner database is in, so scrambles fall back till then.
+            if (const shared_ptr<const CornerPatternDatabase> cornerDB = this->cornerSlot->get())
+            {
+                result.prediction = this->getPredictor(cornerDB)->predict(cube, static_cast<int>(undo.size()),
+                                                                          deadline.has_value());
+                if (result.prediction->route != ROUTE::FALLBACK)
+                {
+                    solveIDAstar();
+                }
+            }
+            // A bounded search that ran out of time falls back too, timedOut still tells it apart.
+            if (!result.solved)
+            {
+                result.moves = undo;
+                result.solved = true;
+            }
+            break;
+        }
+    case ENGINE::POCKET:
+        {
+            if (!this->pocketSolver)
+            {
+                throw invalid_argument("The pocket engine needs a pocket cube database");
+            }
+            RubiksCube2x2 pocket;
+            for (const RubiksCube::MOVE move : scramble)
+            {
+                pocket.move(move);
+            }
+            result.moves = this->pocketSolver->solve(pocket);
+            for (const RubiksCube::MOVE move : result.moves)
+            {
+                pocket.move(move);
+            }
+            result.solved = pocket.isSolved();
+            break;
+        }
+    }
+    // Pocket solutions are already optimal, and the optimizer re-solves windows as a 3x3.
+    if (this->optimizer && result.solved && engine != ENGINE::POCKET)
+    {
+        const vector<RubiksCube::MOVE> optimized = this->optimizer->optimize(result.moves);
+        if (optimized.size() < result.moves.size())
+        {
+            result.movesBeforeOptimizing = result.moves.size();
+            result.moves = optimized;
+        }
+    }
+    result.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+string SolverEngine::toJsonMembers(const SolveResult& result, const ENGINE engine)
+{
+    string solution;
+    for (const RubiksCube::MOVE move : result.moves)
+    {
+        if (!solution.empty()) solution += ' ';
+        solution += RubiksCube::getMove(move);
+    }
+    ostringstream out;
+    out << "\"engine\":\"" << getEngineName(engine) << "\""
+        << ",\"solved\":" << (result.solved ? "true" : "false");
+    if (result.timedOut)
+    {
+        out << ",\"timedOut\":true";
+    }
+    out << ",\"solution\":" << toJsonString(solution)
+        << ",\"moves\":" << result.moves.size();
+    if (result.movesBeforeOptimizing)
+    {
+        out << ",\"movesBeforeOptimizing\":" << *result.movesBeforeOptimizing;
+    }
+    out << ",\"seconds\":" << result.elapsedSeconds;
+    if (result.nodesExpanded)
+    {
+        out << ",\"nodes\":" << *result.nodesExpanded;
+    }
+    if (result.lastIterationNodes)
+    {
+        out << ",\"lastIterationNodes\":" << *result.lastIterationNodes;
+    }
+    if (result.heuristicLookups)
+    {
+        out << ",\"heuristicLookups\":" << *result.heuristicLookups;
+    }
+    if (result.prediction)
+    {
+        out << ",\"route\":\"" << EffortPredictor::getRouteName(result.prediction->route) << "\""
+            << ",\"heuristic\":" << result.prediction->heuristic
+            << ",\"maxDepth\":" << result.prediction->maxDepth
+            << ",\"expectedDepth\":" << result.prediction->expectedDepth
+            << ",\"predictedNodes\":" << result.prediction->totalNodes;
+    }
+    if (result.transposition)
+    {
+        out << ",\"ttProbes\":" << result.transposition->probes
+            << ",\"ttHits\":" << result.transposition->hits
+            << ",\"ttReplacements\":" << result.transposition->replacements;
+    }
+    return out.str();
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+#include "../PatternDatabases/CornerPatternDatabase.h"
+#include "../PatternDatabases/DatabaseSlot.h"
+#include "../PatternDatabases/PerimeterDatabase.h"
+#include "../Solver/EffortPredictor.h"
+#include "../Solver/RubiksCube2x2Solver.h"
+#include "../Solver/SolutionOptimizer.h"
+#include "../Solver/TranspositionTable.h"
+
+#ifndef SOLVERENGINE_H
+#define SOLVERENGINE_H
+
+enum class ENGINE
+{
+    BFS,
+    IDDFS,
+    IDASTAR,
+    // Predicts the idastar effort first, then picks a route, see EffortPredictor.
+    AUTO,
+    // Solves the scramble as a 2x2x2 pocket cube, optimally, from its exact distance table.
+    POCKET
+};
+
+// How the idastar and auto engines search, see the matching IDAstarSolver setters.
+struct SearchTuning
+{
+    bool dualLookups = false;
+    bool batchedLookups = true;
+    bool orderByEstimate = true;
+    bool useHistory = false;
+};
+
+struct SolveResult
+{
+    vector<RubiksCube::MOVE> moves;
+    bool solved = false;
+    bool timedOut = false;
+    double elapsedSeconds = 0;
+    // Only counted by the idastar engine.
+    optional<uint64_t> nodesExpanded;
+    optional<uint64_t> lastIterationNodes;
+    optional<uint64_t> heuristicLookups;
+    // Length of the solution the engine found, set when an optimizer shortened it.
+    optional<size_t> movesBeforeOptimizing;
+    // Only set for the iddfs engine with a transposition table.
+    optional<TranspositionStatistics> transposition;
+    // Only set for the auto engine, and only once the corner database is loaded.
+    optional<EffortPrediction> prediction;
+};
+
+/*
+ * Solves scrambles with any of the solvers, sharing one loaded copy of the
+ * databases. solve() only reads shared state, so one engine can serve any
+ * number of threads.
+ */
+class SolverEngine
+{
+    shared_ptr<const DatabaseSlot<CornerPatternDatabase>> cornerSlot;
+    shared_ptr<const PerimeterDatabase> perimeterDB;
+    int iddfsMaxDepth;
+    shared_ptr<const SolutionOptimizer> optimizer;
+    unsigned bfsThreads;
+    size_t transpositionBytes;
+    uint64_t nodeBudget;
+    shared_ptr<const RubiksCube2x2Solver> pocketSolver;
+    SearchTuning tuning;
+    // Built for the corner database in the slot the first time the auto engine needs it.
+    mutable mutex predictorLock;
+    mutable shared_ptr<const EffortPredictor> predictor;
+
+    // The predictor for cornerDB, counting its values again when the slot's database has been replaced.
+    shared_ptr<const EffortPredictor> getPredictor(const shared_ptr<const CornerPatternDatabase>& cornerDB) const;
+
+public:
+    // The corner slot is only needed by the idastar and auto engines and may be null otherwise.
+    // While its database is still loading, idastar searches on the perimeter alone and auto
+    // falls back. Solutions are passed through the optimizer when one is given. Each bfs solve
+    // is split across bfsThreads threads, on top of the threads solving other scrambles. Each
+    // iddfs solve gets a transposition table of transpositionBytes, or none when it is 0. Auto
+    // searches predicted to take more than nodeBudget nodes are cut short, see EffortPredictor.
+    // The pocket solver is only needed by the pocket engine, whose solutions are never optimized.
+    // Every idastar search, also the ones auto runs, is set up with tuning.
+    SolverEngine(shared_ptr<const DatabaseSlot<CornerPatternDatabase>> _cornerSlot,
+                 shared_ptr<const PerimeterDatabase> _perimeterDB, int _iddfsMaxDepth = 7,
+                 shared_ptr<const SolutionOptimizer> _optimizer = nullptr, unsigned _bfsThreads = 1,
+                 size_t _transpositionBytes = 0, uint64_t _nodeBudget = 10000000,
+                 shared_ptr<const RubiksCube2x2Solver> _pocketSolver = nullptr, SearchTuning _tuning = {});
+
+    // Parses "bfs", "iddfs", "idastar", "auto" or "pocket", throwing invalid_argument for anything else.
+    static ENGINE parseEngine(const string& name);
+
+    static string getEngineName(ENGINE engine);
+
+    // Applies the scramble to a solved cube and solves it. Only the idastar and auto engines
+    // can stop partway at the deadline, the others just skip solves whose deadline has passed.
+    [[nodiscard]] SolveResult solve(const vector<RubiksCube::MOVE>& scramble, ENGINE engine,
+                                    optional<chrono::steady_clock::time_point> deadline = nullopt) const;
+
+    // The result as comma separated JSON members, eg- "engine":"bfs","solved":true,...
+    static string toJsonMembers(const SolveResult& result, ENGINE engine);
+
+    // Whether the idastar and auto engines have the corner database to search with yet.
+    [[nodiscard]] bool isCornerDatabaseLoaded() const;
+};
+
+#endif //SOLVERENGINE_H
@@ -1,48 +1,141 @@
 #pragma once
 #include<bits/stdc++.h>
 #include "../Model/RubiksCube.h"
+#include "../Model/PackedCube.h"
 
 #ifndef BFSSOLVER_H
 #define BFSSOLVER_H
 
-template <typename T, typename H>
+template <typename T>
 class BFSSolver
 {
+    // How a state was first reached. Within a level, the discovery with the lowest
+    // order wins, order being the parent's position in its frontier * 18 + the move.
+    // That is the discovery a one-node-at-a-time search would make first, so the
+    // result does not depend on the number of threads.
+    struct Discovery
+    {
+        uint64_t order;
+        uint32_t depth;
+        RubiksCube::MOVE move;
+    };
+
+    // The visited table is split into shards with a lock each, so threads rarely wait on one another.
+    struct Shard
+    {
+        mutex lock;
+        unordered_map<PackedCube, Discovery, HashPackedCube> states;
+    };
+
+    static constexpr size_t NUM_SHARDS = 64;
+    // Below this many nodes per thread a level is expanded on one thread, the threads would cost more.
+    static constexpr size_t MIN_NODES_PER_THREAD = 1024;
+
     vector<RubiksCube::MOVE> moves;
-    unordered_map<T, bool, H> visited;
-    unordered_map<T, RubiksCube::MOVE, H> movesDone;
+    unsigned numThreads;
+    // Every discovered state, with the move that first reached it. The frontier
+    // and this table hold packed states, cubes are only unpacked to be expanded.
+    array<Shard, NUM_SHARDS> movesDone;
+
+    Shard& getShard(const PackedCube& packed)
+    {
+        return movesDone[(HashPackedCube()(packed) >> 32) % NUM_SHARDS];
+    }
+
     /**
-     * Performs a breadth-first search on the cube to find the shortest path to the solution.
+     * Expands frontier[begin, end) into candidates for the next level.
      *
-     * @return a solved Rubik's Cube
+     * A child is kept as a candidate if it was unvisited or only reached at the same
+     * depth by a discovery with a higher order. It can still lose to a lower order
+     * discovery from another thread, which the caller filters out afterwards.
      */
-    T bfs()
+    void expand(const vector<PackedCube>& frontier, const size_t begin, const size_t end, const uint32_t depth,
+                vector<pair<PackedCube, uint64_t>>& candidates)
     {
-        queue<T> q;
-        q.push(rubiksCube);
-        visited[rubiksCube] = true;
-        while (!q.empty())
+        T node = rubiksCube;
+        for (size_t index = begin; index < end; index++)
         {
-            T node = q.front();
-            q.pop();
-            if (node.isSolved())
-            {
-                return node;
-            }
+            frontier[index].unpack(node);
             for (int i = 0; i < 18; i++)
             {
                 auto currMove = static_cast<RubiksCube::MOVE>(i);
                 node.move(currMove);
-                if (!visited[node])
+                const PackedCube packed = PackedCube::pack(node);
+                const Discovery discovery{index * 18 + i, depth, currMove};
+                Shard& shard = getShard(packed);
+                bool isCandidate;
                 {
-                    visited[node] = true;
-                    movesDone[node] = currMove;
-                    q.push(node);
+                    lock_guard guard(shard.lock);
+                    auto [it, inserted] = shard.states.emplace(packed, discovery);
+                    isCandidate = inserted || (it->second.depth == depth && it->second.order > discovery.order);
+                    if (isCandidate)
+                    {
+                        it->second = discovery;
+                    }
+                }
+                if (isCandidate)
+                {
+                    candidates.emplace_back(packed, discovery.order);
                 }
                 node.invert(currMove);
             }
         }
-        return rubiksCube;
+    }
+
+    /**
+     * Performs a level-synchronous breadth-first search on the cube. Each level's
+     * frontier is split across the threads, which expand their part into buffers
+     * of their own, and the next frontier is gathered from those in order.
+     *
+     * @return a solved Rubik's Cube
+     */
+    T bfs()
+    {
+        const PackedCube solved = PackedCube::solved();
+        const PackedCube start = PackedCube::pack(rubiksCube);
+        getShard(start).states.emplace(start, Discovery{0, 0, RubiksCube::MOVE::L});
+        vector<PackedCube> frontier = {start};
+        uint32_t depth = 0;
+        while (!frontier.empty() && !getShard(solved).states.contains(solved))
+        {
+            ++depth;
+            const size_t threads = clamp<size_t>(frontier.size() / MIN_NODES_PER_THREAD, 1, numThreads);
+            vector<vector<pair<PackedCube, uint64_t>>> candidates(threads);
+            const auto expandPart = [&](const size_t t)
+            {
+                expand(frontier, frontier.size() * t / threads, frontier.size() * (t + 1) / threads, depth,
+                       candidates[t]);
+            };
+            vector<thread> workers;
+            for (size_t t = 1; t < threads; t++)
+            {
+                workers.emplace_back(expandPart, t);
+            }
+            expandPart(0);
+            for (thread& worker : workers)
+            {
+                worker.join();
+            }
+            // Each part is in order and the parts follow each other, so keeping the
+            // winning discoveries in part order gives the next frontier in order.
+            frontier.clear();
+            for (const auto& part : candidates)
+            {
+                for (const auto& [packed, order] : part)
+                {
+                    if (getShard(packed).states.at(packed).order == order)
+                    {
+                        frontier.push_back(packed);
+                    }
+                }
+            }
+        }
+        T node = rubiksCube;
+        if (getShard(solved).states.contains(solved))
+        {
+            solved.unpack(node);
+        }
+        return node;
     }
 
 public:
@@ -51,14 +144,17 @@ public:
      * Constructor for the BFSSolver class.
      *
      * @param _rubiksCube: The Rubik's Cube object for which we want to find a solution.
+     * @param _numThreads: The number of threads each level of the search is split across.
      */
-    explicit BFSSolver(T _rubiksCube)
+    explicit BFSSolver(T _rubiksCube, const unsigned _numThreads = 1)
     {
         rubiksCube = _rubiksCube;
+        numThreads = max(1u, _numThreads);
     }
 
     /**
      * Performs a breadth-first search on the cube to find the shortest path to the solution.
+     * The same solution is found for any number of threads.
      *
      * @return a vector of moves to solve the Rubik's Cube
      */
@@ -69,7 +165,8 @@ public:
         T currCube = solvedCube;
         while (!(currCube == rubiksCube))
         {
-            RubiksCube::MOVE currMove = movesDone[currCube];
+            const PackedCube packed = PackedCube::pack(currCube);
+            RubiksCube::MOVE currMove = getShard(packed).states.at(packed).move;
             moves.push_back(currMove);
             currCube.invert(currMove);
         }
@@ -1,6 +1,7 @@
 #pragma once
 #include<bits/stdc++.h>
 #include "../Model/RubiksCube.h"
+#include "TranspositionTable.h"
 
 #ifndef DFSSOLVER_H
 #define DFSSOLVER_H
@@ -10,6 +11,7 @@ class DFSSolver
 {
     vector<RubiksCube::MOVE> moves;
     int maxDepth;
+    TranspositionTable* table;
     /**
     * Performs a depth-first search to attempt to solve the Rubik's Cube.
     *
@@ -29,6 +31,19 @@ class DFSSolver
         {
             return false;
         }
+        // The number of moves the search may still make from here. With one move left
+        // the children are cheaper to try than packing the cube for a table probe.
+        const auto remaining = static_cast<uint8_t>(maxDepth - depth + 1);
+        const bool useTable = table && remaining > 1;
+        PackedCube packed{};
+        if (useTable)
+        {
+            packed = PackedCube::pack(rubiksCube);
+            if (table->isProvenFailing(packed, remaining))
+            {
+                return false;
+            }
+        }
         for (int i = 0; i < 18; i++)
         {
             rubiksCube.move(static_cast<RubiksCube::MOVE>(i));
@@ -40,6 +55,10 @@ class DFSSolver
             rubiksCube.invert(static_cast<RubiksCube::MOVE>(i));
             moves.pop_back();
         }
+        if (useTable)
+        {
+            table->storeFailing(packed, remaining);
+        }
         return false;
     }
 
@@ -53,11 +72,13 @@ public:
      *
      * @param _rubiksCube The Rubik's Cube object to solve.
      * @param _maxDepth The maximum depth to search in the DFS algorithm. Default is 8.
+     * @param _table Optional transposition table, to skip states already searched as deep or deeper.
      */
-    explicit DFSSolver(T _rubiksCube, const int _maxDepth = 8)
+    explicit DFSSolver(T _rubiksCube, const int _maxDepth = 8, TranspositionTable* _table = nullptr)
     {
         rubiksCube = _rubiksCube;
         maxDepth = _maxDepth;
+        table = _table;
     }
 
     /**
@@ -0,0 +1,101 @@
+#include "EffortPredictor.h"
+#include "../PatternDatabases/DatabaseAnalyzer.h"
+using namespace std;
+
+EffortPredictor::EffortPredictor(shared_ptr<const CornerPatternDatabase> _cornerDB, const uint64_t _nodeBudget)
+    : cornerDB(std::move(_cornerDB)), nodeBudget(_nodeBudget)
+{
+    // Sequences ending on each face, faces being numbered as the moves, L R U D F B.
+    array<double, 6> endingOn{};
+    endingOn.fill(3);
+    treeSizes[0] = 1;
+    treeSizes[1] = 18;
+    for (int depth = 2; depth <= GODS_NUMBER; depth++)
+    {
+        array<double, 6> next{};
+        for (int last = 0; last < 6; last++)
+        {
+            for (int face = 0; face < 6; face++)
+            {
+                // The same pruning as ScrambleGenerator::randomMoves.
+                if (face != last && !(face / 2 == last / 2 && face < last))
+                {
+                    next[face] += 3 * endingOn[last];
+                }
+            }
+        }
+        endingOn = next;
+        treeSizes[depth] = accumulate(endingOn.begin(), endingOn.end(), 0.0);
+    }
+
+    const array<uint64_t, 16> counts = countNibbleValues(this->cornerDB->data(), CornerPatternDatabase::NUM_STATES,
+                                                         thread::hardware_concurrency());
+    // Unset entries count at the bound IDA* clamps them to, see IDAstarSolver::clampCornerEntry.
+    const int unsetBound = this->cornerDB->getUnsetBound();
+    array<double, 21> atValue{};
+    for (int value = 0; value < 0xF; value++)
+    {
+        atValue[min(value, unsetBound)] += static_cast<double>(counts[value]);
+    }
+    atValue[unsetBound] += static_cast<double>(counts[0xF]);
+    const double size = CornerPatternDatabase::NUM_STATES;
+    double seen = 0;
+    for (int value = 0; value <= GODS_NUMBER; value++)
+    {
+        seen += atValue[value];
+        atMost[value] = seen / size;
+        meanHeuristic += value * atValue[value] / size;
+    }
+}
+
+const shared_ptr<const CornerPatternDatabase>& EffortPredictor::getDatabase() const
+{
+    return cornerDB;
+}
+
+double EffortPredictor::predictIteration(const int bound) const
+{
+    double nodes = 0;
+    for (int depth = 0; depth <= min(bound, GODS_NUMBER); depth++)
+    {
+        nodes += treeSizes[depth] * atMost[min(bound - depth, GODS_NUMBER)];
+    }
+    return nodes;
+}
+
+EffortPrediction EffortPredictor::predict(const RubiksCube& cube, const int maxDepth, const bool hasDeadline) const
+{
+    EffortPrediction prediction;
+    const auto [index, dualIndex] = this->cornerDB->getDatabaseIndexAndDual(cube);
+    prediction.maxDepth = clamp(maxDepth, 0, GODS_NUMBER);
+    const uint8_t entry = max(this->cornerDB->getNumMoves(index), this->cornerDB->getNumMoves(dualIndex));
+    prediction.heuristic = min<int>(min(entry, this->cornerDB->getUnsetBound()), prediction.maxDepth);
+    const int gap = static_cast<int>(lround(MEAN_DISTANCE - this->meanHeuristic));
+    prediction.expectedDepth = clamp(prediction.heuristic + gap, prediction.heuristic, prediction.maxDepth);
+    // Iterations below the cube's own heuristic stop at the start node.
+    for (int bound = prediction.heuristic; bound <= prediction.expectedDepth; bound++)
+    {
+        prediction.nodesPerIteration.push_back(this->predictIteration(bound));
+        prediction.totalNodes += prediction.nodesPerIteration.back();
+    }
+    if (prediction.totalNodes <= static_cast<double>(this->nodeBudget))
+    {
+        prediction.route = ROUTE::OPTIMAL;
+    }
+    else
+    {
+        prediction.route = hasDeadline ? ROUTE::BOUNDED : ROUTE::FALLBACK;
+    }
+    return prediction;
+}
+
+string EffortPredictor::getRouteName(const ROUTE route)
+{
+    switch (route)
+    {
+    case ROUTE::OPTIMAL: return "optimal";
+    case ROUTE::BOUNDED: return "bounded";
+    case ROUTE::FALLBACK: return "fallback";
+    default: return "?";
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+#include "../PatternDatabases/CornerPatternDatabase.h"
+
+#ifndef EFFORTPREDICTOR_H
+#define EFFORTPREDICTOR_H
+
+// How a scramble is solved, chosen before any searching starts.
+enum class ROUTE
+{
+    // IDA* until it finds an optimal solution, the search is predicted to be cheap.
+    OPTIMAL,
+    // IDA* until the deadline, then the fallback.
+    BOUNDED,
+    // No search, the scramble undone and simplified, which is fast but not optimal.
+    FALLBACK
+};
+
+struct EffortPrediction
+{
+    // Corner database value of the cube, the bound of the first IDA* iteration that does work.
+    int heuristic = 0;
+    // The longest a solution can be.
+    int maxDepth = 0;
+    // The bound of the last iteration, guessed from the heuristic and never above maxDepth.
+    int expectedDepth = 0;
+    // Predicted nodes expanded by the iteration with bound heuristic + i, up to expectedDepth.
+    vector<double> nodesPerIteration;
+    double totalNodes = 0;
+    ROUTE route = ROUTE::OPTIMAL;
+};
+
+/*
+ * Predicts how many nodes IDA* expands on a cube, with the formula of Korf, Reid
+ * and Edelkamp: the iteration with bound d expands
+ *
+ *     E(d) = sum over i = 0..d of N(i) * P(d - i)
+ *
+ * nodes, N(i) being the number of move sequences of length i that never turn a
+ * face twice in a row nor opposite faces out of order, and P(x) the fraction of
+ * corner database entries of at most x.
+ *
+ * Where the search stops is not known in advance either. A random cube is on
+ * average MEAN_DISTANCE moves from solved, that much more than the table's mean
+ * entry, so the last iteration is taken to be the cube's heuristic plus that gap.
+ *
+ * The estimate can be off both ways. The perimeter and the duplicate states IDA*
+ * drops make the search cheaper than predicted, a solution longer than guessed
+ * makes it dearer. Short scrambles undershoot most: their nodes lie close to
+ * solved, where entries are lower than P assumes. Logging totalNodes next to the
+ * nodes actually expanded shows by how much.
+ */
+class EffortPredictor
+{
+    shared_ptr<const CornerPatternDatabase> cornerDB;
+    uint64_t nodeBudget;
+    // treeSizes[i] = N(i) and atMost[x] = P(x), for every depth a solution can have.
+    array<double, 21> treeSizes{};
+    array<double, 21> atMost{};
+    // Mean entry of the table, unset entries counted at the table's unset bound.
+    double meanHeuristic = 0;
+
+public:
+    // No position of the cube needs more moves than this.
+    static constexpr int GODS_NUMBER = 20;
+    // Mean optimal solution length of a random cube in the half turn metric.
+    static constexpr double MEAN_DISTANCE = 17.7;
+
+    /**
+     * Constructor for the EffortPredictor class.
+     *
+     * @param _cornerDB the corner database IDA* searches with, its values are counted once here
+     * @param _nodeBudget the most nodes a search is predicted to take and still be run to the end
+     */
+    EffortPredictor(shared_ptr<const CornerPatternDatabase> _cornerDB, uint64_t _nodeBudget);
+
+    [[nodiscard]] const shared_ptr<const CornerPatternDatabase>& getDatabase() const;
+
+    // E(bound), the nodes expected in the IDA* iteration with the given bound.
+    [[nodiscard]] double predictIteration(int bound) const;
+
+    /**
+     * Predicts the IDA* iterations from the cube's heuristic up to its expected depth and picks a route.
+     * Searches within the node budget are run to the end. Longer ones are run until the
+     * deadline if there is one, and skipped for the fallback if not.
+     *
+     * @param cube the scrambled cube
+     * @param maxDepth an upper bound on the solution length, eg- the scramble's length
+     * @param hasDeadline whether the solve has a deadline to stop at
+     * @return the predicted iterations and the route
+     */
+    [[nodiscard]] EffortPrediction predict(const RubiksCube& cube, int maxDepth, bool hasDeadline) const;
+
+    static string getRouteName(ROUTE route);
+};
+
+#endif //EFFORTPREDICTOR_H
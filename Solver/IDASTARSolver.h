@@ -1,36 +1,73 @@
 #pragma once
 #include<bits/stdc++.h>
 #include "../Model/RubiksCube.h"
+#include "../Model/PackedCube.h"
 #include "../PatternDatabases/CornerPatternDatabase.h"
+#include "../PatternDatabases/DatabaseRegistry.h"
+#include "../PatternDatabases/DatabaseSlot.h"
+#include "../PatternDatabases/PerimeterDatabase.h"
+#include "SearchStatistics.h"
 
 #ifndef IDASTARSOLVER_H
 #define IDASTARSOLVER_H
 
-template <typename T, typename H>
+template <typename T>
 class IDAstarSolver
 {
-    CornerPatternDatabase cornerDB;
+    // Shared and read-only, so many solvers can search with one loaded copy. Null until
+    // the slot has a database in it, the corner estimate is then 0.
+    shared_ptr<const CornerPatternDatabase> cornerDB;
+    // Where a database loaded in the background turns up, checked before every iteration.
+    shared_ptr<const DatabaseSlot<CornerPatternDatabase>> cornerSlot;
+    shared_ptr<const PerimeterDatabase> perimeterDB;
     vector<RubiksCube::MOVE> moves;
-    unordered_map<T, RubiksCube::MOVE, H> move_done;
-    unordered_map<T, bool, H> visited;
+    // Expanded states with the move that reached them, this doubles as the closed set.
+    unordered_map<PackedCube, RubiksCube::MOVE, HashPackedCube> move_done;
+    SearchStatistics statistics;
+    optional<chrono::steady_clock::time_point> deadline;
+    bool dualLookups = false;
+    bool batchedLookups = true;
+    bool orderByEstimate = true;
+    bool useHistory = false;
+    // How often each move at each depth reached a child closer to solved than its
+    // parent. It is kept across iterations, which revisit the same shallow nodes.
+    vector<array<uint32_t, 18>> history;
 
     struct Node
     {
-        T cube;
+        PackedCube cube;
         int depth;
         int estimate;
+        // The history score of the move that reached the node, taken when it was queued.
+        uint32_t score = 0;
+        // Queue order, so ties fall back to the order the children were generated in.
+        uint64_t sequence = 0;
     };
 
+    // Lowest f first. Ties go to the lower estimate, then the higher history score,
+    // as far as those are switched on, and then to the node queued first.
     struct compareCube
     {
-        bool operator()(pair<Node, int> const& p1, pair<Node, int> const& p2)
+        bool orderByEstimate;
+        bool useHistory;
+
+        bool operator()(pair<Node, int> const& p1, pair<Node, int> const& p2) const
         {
-            Node n1 = p1.first, n2 = p2.first;
-            if (n1.depth + n1.estimate == n2.depth + n2.estimate)
+            const Node& n1 = p1.first;
+            const Node& n2 = p2.first;
+            if (n1.depth + n1.estimate != n2.depth + n2.estimate)
+            {
+                return n1.depth + n1.estimate > n2.depth + n2.estimate;
+            }
+            if (orderByEstimate && n1.estimate != n2.estimate)
             {
                 return n1.estimate > n2.estimate;
             }
-            return n1.depth + n1.estimate > n2.depth + n2.estimate;
+            if (useHistory && n1.score != n2.score)
+            {
+                return n1.score < n2.score;
+            }
+            return n1.sequence > n2.sequence;
         }
     };
 
@@ -38,85 +75,400 @@ class IDAstarSolver
     {
         moves.clear();
         move_done.clear();
-        visited.clear();
     }
 
-    pair<T, int> IDAstar(int bound)
+    /**
+     * Returns the estimated number of moves needed to solve the cube.
+     *
+     * Inside the perimeter the stored distance is exact. Outside it, every
+     * state is at least one move further away than the perimeter depth.
+     *
+     * @param cube the packed cube to estimate
+     * @param cornerEstimate the corner pattern database value of the cube
+     * @return a lower bound on the number of moves to solve the cube
+     */
+    int estimate(const PackedCube& cube, const int cornerEstimate) const
+    {
+        if (perimeterDB->isEmpty())
+        {
+            return cornerEstimate;
+        }
+        const int perimeterMoves = perimeterDB->getNumMoves(cube);
+        if (perimeterMoves != 0xFF)
+        {
+            return perimeterMoves;
+        }
+        return max(cornerEstimate, perimeterDB->getDepth() + 1);
+    }
+
+    /**
+     * Returns the corner pattern database value of the cube, the larger of the
+     * cube's own entry and its inverse's when dual lookups are on.
+     *
+     * The full corner table holds exact corner distances, and those are the same for
+     * the cube conjugated by a whole-cube rotation and for its inverse. Neither lookup
+     * can raise the bound, which is why rotations are never looked up and dual lookups
+     * are off by default. The dual switch is only kept for tables over a subset of the
+     * pieces, where the inverse can project onto a different pattern.
+     */
+    int getCornerEstimate(const T& cube) const
     {
-        priority_queue<pair<Node, int>, vector<pair<Node, int>>, compareCube> pq;
-        Node start = Node(rubiksCube, 0, cornerDB.getNumMoves(rubiksCube));
+        if (!cornerDB)
+        {
+            return 0;
+        }
+        if (!dualLookups)
+        {
+            return clampCornerEntry(cornerDB->getNumMoves(cube));
+        }
+        const auto [index, dualIndex] = cornerDB->getDatabaseIndexAndDual(cube);
+        return clampCornerEntry(max(cornerDB->getNumMoves(index), cornerDB->getNumMoves(dualIndex)));
+    }
+
+    // An unset entry only says the corners are further than the table reaches, taken
+    // raw as 0xF it would overestimate and pathmax would spread it to the neighbours.
+    int clampCornerEntry(const uint8_t entry) const
+    {
+        return min(entry, cornerDB->getUnsetBound());
+    }
+
+    // Takes up the slot's database if it has been replaced. Within an iteration the
+    // database stays the same, every admissible one gives the same optimal solution.
+    void refreshCornerDatabase()
+    {
+        if (!cornerSlot)
+        {
+            return;
+        }
+        shared_ptr<const CornerPatternDatabase> latest = cornerSlot->get();
+        if (latest != cornerDB)
+        {
+            cornerDB = std::move(latest);
+            ++statistics.databaseSwaps;
+            statistics.databaseBacking = getDatabaseBacking();
+        }
+    }
+
+    static shared_ptr<const CornerPatternDatabase> acquireCornerDatabase(const string& fileName)
+    {
+        shared_ptr<const CornerPatternDatabase> corners =
+            DatabaseRegistry::global().acquire<CornerPatternDatabase>(fileName);
+        if (!corners)
+        {
+            throw runtime_error("Cannot open corner database " + fileName);
+        }
+        return corners;
+    }
+
+    string getDatabaseBacking() const
+    {
+        return cornerDB ? cornerDB->getStorageBacking() : "none";
+    }
+
+    pair<PackedCube, int> IDAstar(int bound)
+    {
+        priority_queue<pair<Node, int>, vector<pair<Node, int>>, compareCube> pq(
+            compareCube{orderByEstimate, useHistory});
+        uint64_t sequence = 0;
+        const uint64_t nodesBefore = statistics.nodesExpanded;
+        const PackedCube packedStart = PackedCube::pack(rubiksCube);
+        Node start = Node(packedStart, 0, estimate(packedStart, getCornerEstimate(rubiksCube)));
         pq.push(make_pair(start, 0));
         int next_bound = 100;
+        // Nodes are queued packed, each one is unpacked into this cube to be expanded.
+        T cube = rubiksCube;
         while (!pq.empty())
         {
             auto p = pq.top();
             Node node = p.first;
             pq.pop();
-            if (visited[node.cube])
+            if (!move_done.emplace(node.cube, static_cast<RubiksCube::MOVE>(p.second)).second)
             {
                 continue;
             }
-            visited[node.cube] = true;
-            move_done[node.cube] = static_cast<RubiksCube::MOVE>(p.second);
-            if (node.cube.isSolved())
+            // Entering the perimeter ends the search, the rest of the path is stitched on from the table.
+            if (node.cube == PackedCube::solved() || (!perimeterDB->isEmpty() && node.estimate <= perimeterDB->getDepth()))
             {
+                statistics.lastIterationNodes = statistics.nodesExpanded - nodesBefore;
                 return make_pair(node.cube, bound);
             }
             ++node.depth;
+            ++statistics.nodesExpanded;
+            // Reading the clock for every node would cost more than the node itself.
+            if (deadline && statistics.nodesExpanded % 1024 == 0 && chrono::steady_clock::now() >= *deadline)
+            {
+                statistics.timedOut = true;
+                return make_pair(packedStart, bound);
+            }
+            node.cube.unpack(cube);
+            // Index every unvisited child first, so their database lookups can be issued together.
+            // With dual lookups each child takes two entries, its own and its inverse's.
+            const size_t lookupsPerChild = !cornerDB ? 0 : dualLookups ? 2 : 1;
+            array<PackedCube, 18> children{};
+            array<int, 18> childMoves{};
+            array<uint32_t, 36> childIndices{};
+            array<uint8_t, 36> childEstimates{};
+            size_t numChildren = 0;
             for (int i = 0; i < 18; i++)
             {
                 auto curr_move = static_cast<RubiksCube::MOVE>(i);
-                node.cube.move(curr_move);
-                if (!visited[node.cube])
+                cube.move(curr_move);
+                const PackedCube child = PackedCube::pack(cube);
+                if (!move_done.contains(child))
                 {
-                    node.estimate = cornerDB.getNumMoves(node.cube);
-                    if (node.estimate + node.depth > bound)
+                    children[numChildren] = child;
+                    childMoves[numChildren] = i;
+                    if (lookupsPerChild == 2)
                     {
-                        next_bound = min(next_bound, node.estimate + node.depth);
+                        tie(childIndices[2 * numChildren], childIndices[2 * numChildren + 1]) =
+                            cornerDB->getDatabaseIndexAndDual(cube);
                     }
-                    else
+                    else if (lookupsPerChild == 1)
                     {
-                        pq.push(make_pair(node, i));
+                        childIndices[numChildren] = cornerDB->getDatabaseIndex(cube);
                     }
+                    if (!batchedLookups)
+                    {
+                        for (size_t k = numChildren * lookupsPerChild; k < (numChildren + 1) * lookupsPerChild; k++)
+                        {
+                            childEstimates[k] = cornerDB->getNumMoves(childIndices[k]);
+                        }
+                    }
+                    ++numChildren;
+                }
+                cube.invert(curr_move);
+            }
+            if (cornerDB && batchedLookups)
+            {
+                cornerDB->getNumMovesBatch(childIndices.data(), childEstimates.data(), numChildren * lookupsPerChild);
+            }
+            statistics.nodesGenerated += numChildren;
+            statistics.heuristicLookups += numChildren * lookupsPerChild;
+            array<int, 18> estimates{};
+            int maxEstimate = 0;
+            for (size_t i = 0; i < numChildren; i++)
+            {
+                const uint8_t* entries = childEstimates.data() + i * lookupsPerChild;
+                const int cornerEstimate = lookupsPerChild == 0
+                                               ? 0
+                                               : clampCornerEntry(*max_element(entries, entries + lookupsPerChild));
+                estimates[i] = estimate(children[i], cornerEstimate);
+                maxEstimate = max(maxEstimate, estimates[i]);
+            }
+            // Bidirectional pathmax: a node is at most one move closer than any of its
+            // children, and a child at most one move closer than the node. When the first
+            // rule pushes the node over the bound, none of its children need queueing.
+            const int nodeEstimate = max(node.estimate, maxEstimate - 1);
+            if (node.depth - 1 + nodeEstimate > bound)
+            {
+                ++statistics.pathmaxCutoffs;
+                next_bound = min(next_bound, node.depth - 1 + nodeEstimate);
+                continue;
+            }
+            if (useHistory && history.size() < static_cast<size_t>(node.depth))
+            {
+                history.resize(node.depth);
+            }
+            for (size_t i = 0; i < numChildren; i++)
+            {
+                Node child = Node(children[i], node.depth, max(estimates[i], nodeEstimate - 1));
+                child.sequence = sequence++;
+                if (useHistory)
+                {
+                    uint32_t& score = history[node.depth - 1][childMoves[i]];
+                    score += estimates[i] < node.estimate;
+                    child.score = score;
+                }
+                if (child.estimate + child.depth > bound)
+                {
+                    next_bound = min(next_bound, child.estimate + child.depth);
+                }
+                else
+                {
+                    pq.push(make_pair(child, childMoves[i]));
                 }
-                node.cube.invert(curr_move);
             }
         }
-        return make_pair(rubiksCube, next_bound);
+        statistics.lastIterationNodes = statistics.nodesExpanded - nodesBefore;
+        return make_pair(packedStart, next_bound);
     }
 
 public:
     T rubiksCube;
 
+    // The corner database comes from the process-wide registry, solvers loading the same file share one copy.
     IDAstarSolver(T& _rubiksCube, const string& fileName)
     {
         rubiksCube = _rubiksCube;
-        cornerDB.fromFile(fileName);
+        cornerDB = acquireCornerDatabase(fileName);
+        perimeterDB = make_shared<const PerimeterDatabase>();
+    }
+
+    /**
+     * Constructor for the IDAstarSolver class with a perimeter database.
+     *
+     * The perimeter database holds every state within a few moves of the
+     * solved cube, so the search stops as soon as it reaches one of them.
+     * A missing perimeter file falls back to searching down to the solved cube.
+     * Both databases come from the process-wide registry, see DatabaseRegistry.
+     *
+     * @param _rubiksCube the Rubik's Cube object to solve
+     * @param fileName the corner pattern database file
+     * @param perimeterFileName the perimeter database file
+     */
+    IDAstarSolver(T& _rubiksCube, const string& fileName, const string& perimeterFileName)
+    {
+        rubiksCube = _rubiksCube;
+        cornerDB = acquireCornerDatabase(fileName);
+        perimeterDB = DatabaseRegistry::global().acquire<PerimeterDatabase>(perimeterFileName);
+        if (!perimeterDB)
+        {
+            perimeterDB = make_shared<const PerimeterDatabase>();
+        }
+    }
+
+    /**
+     * Constructor for the IDAstarSolver class with databases that are already loaded.
+     *
+     * The databases are only read, so the same ones can be handed to any
+     * number of solvers, including solvers running on other threads.
+     *
+     * @param _rubiksCube the Rubik's Cube object to solve
+     * @param _cornerDB the corner pattern database
+     * @param _perimeterDB the perimeter database, empty to search down to the solved cube
+     */
+    IDAstarSolver(T& _rubiksCube, shared_ptr<const CornerPatternDatabase> _cornerDB,
+                  shared_ptr<const PerimeterDatabase> _perimeterDB = make_shared<const PerimeterDatabase>())
+        : cornerDB(std::move(_cornerDB)), perimeterDB(std::move(_perimeterDB))
+    {
+        rubiksCube = _rubiksCube;
+    }
+
+    /**
+     * Constructor for the IDAstarSolver class with a corner database that may still be loading.
+     *
+     * The solver searches with whatever database is in the slot, none at first if need
+     * be, and takes up a newer one at the start of its next iteration. The bounds found
+     * with the weaker heuristic stay valid, so the solution is still optimal.
+     *
+     * @param _rubiksCube the Rubik's Cube object to solve
+     * @param _cornerSlot the slot the corner pattern database is put in
+     * @param _perimeterDB the perimeter database, empty to search down to the solved cube
+     */
+    IDAstarSolver(T& _rubiksCube, shared_ptr<const DatabaseSlot<CornerPatternDatabase>> _cornerSlot,
+                  shared_ptr<const PerimeterDatabase> _perimeterDB = make_shared<const PerimeterDatabase>())
+        : cornerSlot(std::move(_cornerSlot)), perimeterDB(std::move(_perimeterDB))
+    {
+        rubiksCube = _rubiksCube;
     }
 
     vector<RubiksCube::MOVE> solve()
     {
+        const auto start_time = chrono::steady_clock::now();
+        // A solver can be asked to solve again, nothing from the last search may carry over.
+        resetStructure();
+        statistics = SearchStatistics();
+        refreshCornerDatabase();
+        statistics.databaseSwaps = 0;
+        statistics.databaseBacking = getDatabaseBacking();
+        history.clear();
         int bound = 1;
         auto p = IDAstar(bound);
+        ++statistics.iterations;
         while (p.second != bound)
         {
             resetStructure();
             bound = p.second;
+            refreshCornerDatabase();
             p = IDAstar(bound);
+            ++statistics.iterations;
+        }
+        statistics.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        if (statistics.timedOut)
+        {
+            return moves;
         }
-        T solved_cube = p.first;
-        assert(solved_cube.isSolved());
+        T solved_cube = rubiksCube;
+        p.first.unpack(solved_cube);
         T curr_cube = solved_cube;
         while (!(curr_cube == rubiksCube))
         {
-            RubiksCube::MOVE curr_move = move_done[curr_cube];
+            RubiksCube::MOVE curr_move = move_done.at(PackedCube::pack(curr_cube));
             moves.push_back(curr_move);
             curr_cube.invert(curr_move);
         }
-        rubiksCube = solved_cube;
         ranges::reverse(moves);
+        while (!solved_cube.isSolved())
+        {
+            RubiksCube::MOVE curr_move = perimeterDB->getSolvingMove(solved_cube);
+            moves.push_back(curr_move);
+            solved_cube.move(curr_move);
+        }
+        rubiksCube = solved_cube;
         return moves;
     }
+
+    /**
+     * Makes solve() give up once the deadline has passed. It then returns no
+     * moves, leaves rubiksCube as it was and flags timedOut in the statistics.
+     *
+     * @param _deadline the time to give up at
+     */
+    void setDeadline(const chrono::steady_clock::time_point _deadline)
+    {
+        deadline = _deadline;
+    }
+
+    /**
+     * Turns looking up each state's inverse in the corner database on or off, it is off by default.
+     *
+     * The full corner table holds exact distances, and a state and its inverse are the
+     * same distance from solved, so for it the dual entry always equals the regular one
+     * and only doubles the lookups. It pays off for tables of a subset of the pieces,
+     * where a state and its inverse project onto different patterns.
+     *
+     * @param enabled whether to take the larger of the regular and the dual entry
+     */
+    void setDualLookups(const bool enabled)
+    {
+        dualLookups = enabled;
+    }
+
+    /**
+     * Turns batching the children's corner lookups on or off, it is on by default.
+     * Without it each child's entry is read as soon as it is indexed, one cache
+     * miss after another, which is only useful to measure what batching saves.
+     *
+     * @param enabled whether to prefetch every child's entry before reading any
+     */
+    void setBatchedLookups(const bool enabled)
+    {
+        batchedLookups = enabled;
+    }
+
+    /**
+     * Chooses how nodes with the same f are ordered. By default the lower
+     * estimate goes first, which tends to reach the goal sooner in the last
+     * iteration. Without it they are taken in the order they were generated.
+     *
+     * @param byEstimate whether to expand the lower estimate first
+     * @param withHistory whether to then prefer moves that got closer to solved at the same depth before
+     */
+    void setChildOrdering(const bool byEstimate, const bool withHistory)
+    {
+        orderByEstimate = byEstimate;
+        useHistory = withHistory;
+    }
+
+    /**
+     * Returns the node and lookup counts of the last call to solve().
+     *
+     * @return the statistics of the last search
+     */
+    [[nodiscard]] const SearchStatistics& getStatistics() const
+    {
+        return statistics;
+    }
 };
 
 #endif //IDASTARSOLVER_H
@@ -11,6 +11,7 @@ class IDDFSSolver
 {
     int maxDepth;
     vector<RubiksCube::MOVE> moves;
+    TranspositionTable* table;
 
 public:
     T rubiksCube;
@@ -22,11 +23,14 @@ public:
     *
     * @param _rubiksCube The Rubik's Cube object to solve.
     * @param _maxDepth The initial maximum search depth for the IDDFS algorithm. Default is 7.
+    * @param _table Optional transposition table. It is shared by every iteration, what
+    * one iteration proves unsolvable within some moves stays so in the next.
     */
-    explicit IDDFSSolver(T _rubiksCube, const int _maxDepth = 7)
+    explicit IDDFSSolver(T _rubiksCube, const int _maxDepth = 7, TranspositionTable* _table = nullptr)
     {
         rubiksCube = _rubiksCube;
         maxDepth = _maxDepth;
+        table = _table;
     }
 
     /**
@@ -42,7 +46,7 @@ public:
     {
         for (int i = 1; i <= maxDepth; i++)
         {
-            DFSSolver<T> dfsSolver(rubiksCube, i);
+            DFSSolver<T> dfsSolver(rubiksCube, i, table);
             moves = dfsSolver.solve();
             if (dfsSolver.rubiksCube.isSolved())
             {
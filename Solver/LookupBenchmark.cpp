@@ -0,0 +1,127 @@
+#include "LookupBenchmark.h"
+#include "IDASTARSolver.h"
+#include "../Model/RubiksCubeBitboard.cpp"
+#include "../Model/ScrambleGenerator.h"
+using namespace std;
+
+namespace
+{
+    // Enough random entries to miss the cache on nearly every read, in batches of one node's children.
+    constexpr size_t TABLE_LOOKUPS = 18 << 16;
+    constexpr size_t BATCH_SIZE = 18;
+
+    double secondsSince(const chrono::steady_clock::time_point start)
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    LookupSearchTotals solveAll(const shared_ptr<const CornerPatternDatabase>& cornerDB,
+                                const vector<vector<RubiksCube::MOVE>>& scrambles, const bool batched)
+    {
+        LookupSearchTotals totals;
+        for (const vector<RubiksCube::MOVE>& scramble : scrambles)
+        {
+            RubiksCubeBitboard cube;
+            for (const RubiksCube::MOVE move : scramble)
+            {
+                cube.move(move);
+            }
+            IDAstarSolver<RubiksCubeBitboard> solver(cube, cornerDB);
+            solver.setBatchedLookups(batched);
+            totals.solutionMoves += solver.solve().size();
+            const SearchStatistics& statistics = solver.getStatistics();
+            totals.nodesExpanded += statistics.nodesExpanded;
+            totals.heuristicLookups += statistics.heuristicLookups;
+            totals.seconds += statistics.elapsedSeconds;
+        }
+        return totals;
+    }
+}
+
+LookupBenchmarkReport benchmarkLookups(const shared_ptr<const CornerPatternDatabase>& cornerDB,
+                                       const uint64_t scrambles, const unsigned int scrambleLength,
+                                       const uint64_t seed)
+{
+    LookupBenchmarkReport report;
+    ScrambleGenerator generator(seed);
+    vector<uint32_t> indices(TABLE_LOOKUPS);
+    for (uint32_t& index : indices)
+    {
+        index = static_cast<uint32_t>(generator.nextBelow(CornerPatternDatabase::NUM_STATES));
+    }
+    array<uint8_t, BATCH_SIZE> entries{};
+    // Summed and checked, so neither loop can be optimised away.
+    uint64_t batchedSum = 0, singleSum = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < TABLE_LOOKUPS; i += BATCH_SIZE)
+    {
+        cornerDB->getNumMovesBatch(indices.data() + i, entries.data(), BATCH_SIZE);
+        batchedSum += accumulate(entries.begin(), entries.end(), uint64_t{0});
+    }
+    const double batchedSeconds = secondsSince(start);
+    start = chrono::steady_clock::now();
+    for (const uint32_t index : indices)
+    {
+        singleSum += cornerDB->getNumMoves(index);
+    }
+    const double singleSeconds = secondsSince(start);
+    if (batchedSum != singleSum)
+    {
+        throw logic_error("Batched and single lookups read different entries");
+    }
+    report.tableLookups = TABLE_LOOKUPS;
+    report.batchedNsPerLookup = batchedSeconds * 1e9 / TABLE_LOOKUPS;
+    report.singleNsPerLookup = singleSeconds * 1e9 / TABLE_LOOKUPS;
+
+    vector<vector<RubiksCube::MOVE>> scrambleMoves;
+    for (uint64_t i = 0; i < scrambles; i++)
+    {
+        scrambleMoves.push_back(generator.randomMoves(scrambleLength));
+    }
+    report.scrambles = scrambles;
+    report.scrambleLength = scrambleLength;
+    report.batched = solveAll(cornerDB, scrambleMoves, true);
+    report.perChild = solveAll(cornerDB, scrambleMoves, false);
+    return report;
+}
+
+void printLookupBenchmarkReport(ostream& out, const LookupBenchmarkReport& report)
+{
+    const auto rate = [](const uint64_t count, const double seconds)
+    {
+        return seconds > 0 ? static_cast<double>(count) / seconds : 0;
+    };
+    out << fixed << setprecision(1)
+        << "table lookups:   " << report.tableLookups << " random entries, 18 at a time\n"
+        << "  batched:       " << report.batchedNsPerLookup << " ns per lookup\n"
+        << "  one by one:    " << report.singleNsPerLookup << " ns per lookup\n"
+        << "searches:        " << report.scrambles << " scrambles of " << report.scrambleLength << " moves, "
+        << report.batched.nodesExpanded << " nodes and " << report.batched.heuristicLookups << " lookups each way\n"
+        << "  batched:       " << rate(report.batched.nodesExpanded, report.batched.seconds) << " nodes/s in "
+        << setprecision(3) << report.batched.seconds << "s\n" << setprecision(1)
+        << "  per child:     " << rate(report.perChild.nodesExpanded, report.perChild.seconds) << " nodes/s in "
+        << setprecision(3) << report.perChild.seconds << "s\n"
+        << defaultfloat;
+}
+
+string toJson(const LookupBenchmarkReport& report)
+{
+    const auto totals = [](const LookupSearchTotals& t)
+    {
+        ostringstream out;
+        out << "{\"nodes\":" << t.nodesExpanded
+            << ",\"lookups\":" << t.heuristicLookups
+            << ",\"solutionMoves\":" << t.solutionMoves
+            << ",\"seconds\":" << t.seconds << "}";
+        return out.str();
+    };
+    ostringstream out;
+    out << "{\"tableLookups\":" << report.tableLookups
+        << ",\"batchedNsPerLookup\":" << report.batchedNsPerLookup
+        << ",\"singleNsPerLookup\":" << report.singleNsPerLookup
+        << ",\"scrambles\":" << report.scrambles
+        << ",\"scrambleLength\":" << report.scrambleLength
+        << ",\"batched\":" << totals(report.batched)
+        << ",\"perChild\":" << totals(report.perChild) << "}";
+    return out.str();
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "../PatternDatabases/CornerPatternDatabase.h"
+
+#ifndef LOOKUPBENCHMARK_H
+#define LOOKUPBENCHMARK_H
+
+// Totals over every scramble solved with one lookup mode.
+struct LookupSearchTotals
+{
+    uint64_t nodesExpanded = 0;
+    uint64_t heuristicLookups = 0;
+    uint64_t solutionMoves = 0;
+    double seconds = 0;
+};
+
+struct LookupBenchmarkReport
+{
+    // Table alone: random entries read 18 at a time, prefetched together or one after another.
+    uint64_t tableLookups = 0;
+    double batchedNsPerLookup = 0;
+    double singleNsPerLookup = 0;
+    // Search: the same scrambles solved by IDA* with each mode.
+    uint64_t scrambles = 0;
+    unsigned int scrambleLength = 0;
+    LookupSearchTotals batched;
+    LookupSearchTotals perChild;
+};
+
+/**
+ * Measures what batching and prefetching the corner lookups of a node's children
+ * saves, first on the table alone and then in whole IDA* searches. Both modes
+ * read the same entries and expand the same nodes, only the time differs.
+ *
+ * @param cornerDB the corner database to look up in
+ * @param scrambles the number of random scrambles to solve with each mode
+ * @param scrambleLength the moves per scramble, keep it short, each one is solved optimally
+ * @param seed the seed the entries and scrambles are drawn with
+ * @return the timings of both modes
+ */
+LookupBenchmarkReport benchmarkLookups(const shared_ptr<const CornerPatternDatabase>& cornerDB, uint64_t scrambles,
+                                       unsigned int scrambleLength, uint64_t seed);
+
+// A report for people, one statistic per line.
+void printLookupBenchmarkReport(ostream& out, const LookupBenchmarkReport& report);
+
+// The report as one JSON object.
+string toJson(const LookupBenchmarkReport& report);
+
+#endif //LOOKUPBENCHMARK_H
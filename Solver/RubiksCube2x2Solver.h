@@ -0,0 +1,162 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "../PatternDatabases/RubiksCube2x2Database.h"
+
+#ifndef RUBIKSCUBE2X2SOLVER_H
+#define RUBIKSCUBE2X2SOLVER_H
+
+/*
+ * Optimal pocket cube solver. The distance table is exact, so following any
+ * move that lowers the distance by one is an optimal solution, no search needed.
+ */
+class RubiksCube2x2Solver
+{
+    RubiksCube2x2Database database;
+
+    // Number of cubes descended together in a batch, so their table reads overlap.
+    static constexpr size_t LANES = 16;
+
+public:
+    // No pocket cube is more than 11 moves from solved.
+    static constexpr size_t MAX_MOVES = 11;
+    // solveBatch's length for a cube the table cannot solve, its moves are then not valid.
+    static constexpr uint8_t UNSOLVED = 0xFF;
+
+    /**
+     * Constructor for the RubiksCube2x2Solver class.
+     *
+     * The table is loaded from fileName. If the file does not exist it is
+     * generated, which takes well under a second, and written there.
+     *
+     * @param fileName the pocket cube database file
+     */
+    explicit RubiksCube2x2Solver(const string& fileName)
+    {
+        if (!database.fromFile(fileName))
+        {
+            database.generate();
+            database.toFile(fileName);
+        }
+    }
+
+    /**
+     * Solves a pocket cube optimally.
+     *
+     * @param cube the cube to solve
+     * @return the moves that solve the cube, as U, R and F turns
+     * @throws runtime_error if the table is damaged and has no path to solved from the cube
+     */
+    [[nodiscard]] vector<RubiksCube::MOVE> solve(RubiksCube2x2 cube) const
+    {
+        vector<RubiksCube::MOVE> moves;
+        uint8_t numMoves = database.getNumMoves(cube);
+        if (numMoves > MAX_MOVES)
+        {
+            throw runtime_error("The pocket cube database has no distance for this cube");
+        }
+        while (numMoves != 0)
+        {
+            int generator = 0;
+            while (generator < RubiksCube2x2::NUM_GENERATORS &&
+                database.getNumMoves(cube.getChild(generator)) != numMoves - 1)
+            {
+                ++generator;
+            }
+            if (generator == RubiksCube2x2::NUM_GENERATORS)
+            {
+                throw runtime_error("The pocket cube database is damaged, no move gets closer to solved");
+            }
+            moves.push_back(RubiksCube2x2::GENERATORS[generator]);
+            cube = cube.getChild(generator);
+            --numMoves;
+        }
+        return moves;
+    }
+
+    /**
+     * Solves many pocket cubes optimally.
+     *
+     * Cubes are descended LANES at a time with every child's table entry
+     * prefetched before any is read, and the batch is split across threads.
+     *
+     * @param cubes the cubes to solve
+     * @param n the number of cubes
+     * @param moves receives the solution of cube i at moves[i * MAX_MOVES]
+     * @param numMoves receives the length of the solution of cube i, UNSOLVED where the table is damaged
+     * @param numThreads the number of threads to split the batch across
+     */
+    void solveBatch(const RubiksCube2x2* cubes, const size_t n, RubiksCube::MOVE* moves, uint8_t* numMoves,
+                    const unsigned numThreads = 1) const
+    {
+        const auto solveRange = [&](const size_t begin, const size_t end)
+        {
+            for (size_t first = begin; first < end; first += LANES)
+            {
+                const size_t numLanes = min(LANES, end - first);
+                array<RubiksCube2x2, LANES> lanes{};
+                array<uint8_t, LANES> remaining{};
+                for (size_t lane = 0; lane < numLanes; ++lane)
+                {
+                    lanes[lane] = cubes[first + lane];
+                    remaining[lane] = numMoves[first + lane] = database.getNumMoves(lanes[lane]);
+                    if (remaining[lane] > MAX_MOVES)
+                    {
+                        remaining[lane] = 0;
+                        numMoves[first + lane] = UNSOLVED;
+                    }
+                }
+                for (uint8_t step = 0; step < MAX_MOVES; ++step)
+                {
+                    // Children of every unfinished lane, looked up in one batch.
+                    constexpr int G = RubiksCube2x2::NUM_GENERATORS;
+                    array<uint32_t, LANES * G> children{};
+                    array<uint8_t, LANES * G> distances{};
+                    array<size_t, LANES> activeLanes{};
+                    size_t numActive = 0;
+                    for (size_t lane = 0; lane < numLanes; ++lane)
+                    {
+                        if (remaining[lane] == 0) continue;
+                        for (int generator = 0; generator < G; ++generator)
+                        {
+                            children[numActive * G + generator] = lanes[lane].getChild(generator).getIndex();
+                        }
+                        activeLanes[numActive++] = lane;
+                    }
+                    if (numActive == 0) break;
+                    database.getNumMovesBatch(children.data(), distances.data(), numActive * G);
+                    for (size_t i = 0; i < numActive; ++i)
+                    {
+                        const size_t lane = activeLanes[i];
+                        const uint8_t* laneDistances = distances.data() + i * G;
+                        const int generator = static_cast<int>(
+                            find(laneDistances, laneDistances + G, remaining[lane] - 1) - laneDistances);
+                        if (generator == G)
+                        {
+                            // Only a damaged table has no child one move closer.
+                            numMoves[first + lane] = UNSOLVED;
+                            remaining[lane] = 0;
+                            continue;
+                        }
+                        moves[(first + lane) * MAX_MOVES + step] = RubiksCube2x2::GENERATORS[generator];
+                        lanes[lane] = RubiksCube2x2::fromIndex(children[i * G + generator]);
+                        --remaining[lane];
+                    }
+                }
+            }
+        };
+
+        const size_t threads = max<size_t>(1, min<size_t>(numThreads, n / LANES));
+        vector<thread> workers;
+        for (size_t t = 1; t < threads; ++t)
+        {
+            workers.emplace_back(solveRange, n * t / threads, n * (t + 1) / threads);
+        }
+        solveRange(0, n / threads);
+        for (thread& worker : workers)
+        {
+            worker.join();
+        }
+    }
+};
+
+#endif //RUBIKSCUBE2X2SOLVER_H
@@ -0,0 +1,36 @@
+#pragma once
+#include<bits/stdc++.h>
+using namespace std;
+
+#ifndef SEARCHSTATISTICS_H
+#define SEARCHSTATISTICS_H
+
+struct SearchStatistics
+{
+    uint64_t nodesExpanded = 0;
+    uint64_t nodesGenerated = 0;
+    uint64_t heuristicLookups = 0;
+    // Nodes dropped because a child's estimate showed they were over the bound.
+    uint64_t pathmaxCutoffs = 0;
+    uint32_t iterations = 0;
+    // Nodes expanded by the last iteration alone, the one that reached the goal.
+    uint64_t lastIterationNodes = 0;
+    double elapsedSeconds = 0;
+    string databaseBacking;
+    // Times a newer corner database was taken up between iterations.
+    uint32_t databaseSwaps = 0;
+    // The search gave up at its deadline without a solution.
+    bool timedOut = false;
+
+    /**
+     * Returns the number of nodes expanded per second of search.
+     *
+     * @return the expansion rate, or 0 if no time has been recorded
+     */
+    [[nodiscard]] double getNodesPerSecond() const
+    {
+        return elapsedSeconds > 0 ? static_cast<double>(nodesExpanded) / elapsedSeconds : 0;
+    }
+};
+
+#endif //SEARCHSTATISTICS_H
@@ -0,0 +1,134 @@
+#include "SolutionOptimizer.h"
+#include "../PatternDatabases/PerimeterDBMaker.h"
+using namespace std;
+
+namespace
+{
+    // Moves come in threes per face, in the order L, R, U, D, F, B, so opposite faces share an axis.
+    int getFace(const RubiksCube::MOVE move)
+    {
+        return static_cast<int>(move) / 3;
+    }
+
+    int getAxis(const RubiksCube::MOVE move)
+    {
+        return getFace(move) / 2;
+    }
+
+    // Clockwise quarter turns of a move, eg- 3 for R'.
+    int getQuarterTurns(const RubiksCube::MOVE move)
+    {
+        constexpr int turns[3] = {1, 3, 2};
+        return turns[static_cast<int>(move) % 3];
+    }
+
+    // Returns the move turning face by quarterTurns, which must not be a multiple of 4.
+    RubiksCube::MOVE getMove(const int face, const int quarterTurns)
+    {
+        constexpr int offsets[4] = {0, 0, 2, 1};
+        return static_cast<RubiksCube::MOVE>(face * 3 + offsets[quarterTurns % 4]);
+    }
+}
+
+SolutionOptimizer::SolutionOptimizer(shared_ptr<const PerimeterDatabase> _perimeterDB, const size_t _maxWindow)
+    : perimeterDB(std::move(_perimeterDB)), maxWindow(_maxWindow)
+{
+    if (!this->perimeterDB || this->perimeterDB->isEmpty())
+    {
+        PerimeterDBMaker maker("", 4);
+        maker.bfs();
+        this->perimeterDB = make_shared<const PerimeterDatabase>(maker.getDatabase());
+    }
+}
+
+vector<RubiksCube::MOVE> SolutionOptimizer::cancelMoves(const vector<RubiksCube::MOVE>& moves)
+{
+    // No move in result is on the face of the move before it, or of the one before that
+    // when the move between them is on the opposite face. So each new move only has
+    // to be checked against the last two.
+    vector<RubiksCube::MOVE> result;
+    for (const RubiksCube::MOVE move : moves)
+    {
+        size_t target = result.size();
+        if (!result.empty() && getFace(result.back()) == getFace(move))
+        {
+            target = result.size() - 1;
+        }
+        else if (result.size() >= 2 && getAxis(result.back()) == getAxis(move) &&
+            getFace(result[result.size() - 2]) == getFace(move))
+        {
+            target = result.size() - 2;
+        }
+        if (target == result.size())
+        {
+            result.push_back(move);
+            continue;
+        }
+        const int quarterTurns = (getQuarterTurns(result[target]) + getQuarterTurns(move)) % 4;
+        if (quarterTurns == 0)
+        {
+            result.erase(result.begin() + static_cast<ptrdiff_t>(target));
+        }
+        else
+        {
+            result[target] = getMove(getFace(move), quarterTurns);
+        }
+    }
+    return result;
+}
+
+vector<RubiksCube::MOVE> SolutionOptimizer::solveWindow(const span<const RubiksCube::MOVE> window) const
+{
+    // The window takes the solved cube to cube, so the database's path from cube back to
+    // solved, inverted and reversed, has the same effect as the window.
+    RubiksCubeBitboard cube;
+    for (const RubiksCube::MOVE move : window)
+    {
+        cube.move(move);
+    }
+    vector<RubiksCube::MOVE> sequence;
+    while (!cube.isSolved())
+    {
+        const RubiksCube::MOVE move = perimeterDB->getSolvingMove(cube);
+        sequence.push_back(RubiksCube::getInverseMove(move));
+        cube.move(move);
+    }
+    ranges::reverse(sequence);
+    return sequence;
+}
+
+vector<RubiksCube::MOVE> SolutionOptimizer::optimize(const vector<RubiksCube::MOVE>& moves) const
+{
+    vector<RubiksCube::MOVE> result = cancelMoves(moves);
+    size_t start = 0;
+    while (start + 1 < result.size())
+    {
+        // Grow a window from start one move at a time, keeping the one that saves the most moves.
+        RubiksCubeBitboard cube;
+        size_t bestLength = 0;
+        size_t bestSaving = 0;
+        for (size_t length = 1; length <= min(maxWindow, result.size() - start); ++length)
+        {
+            cube.move(result[start + length - 1]);
+            const uint8_t numMoves = perimeterDB->getNumMoves(cube);
+            if (numMoves != 0xFF && numMoves < length && length - numMoves > bestSaving)
+            {
+                bestLength = length;
+                bestSaving = length - numMoves;
+            }
+        }
+        if (bestSaving == 0)
+        {
+            ++start;
+            continue;
+        }
+        const vector<RubiksCube::MOVE> sequence = this->solveWindow(span(result).subspan(start, bestLength));
+        const auto first = result.begin() + static_cast<ptrdiff_t>(start);
+        result.erase(first, first + static_cast<ptrdiff_t>(bestLength));
+        result.insert(result.begin() + static_cast<ptrdiff_t>(start), sequence.begin(), sequence.end());
+        result = cancelMoves(result);
+        // The new moves can shorten windows that begin a little earlier.
+        start = start >= maxWindow ? start - maxWindow : 0;
+    }
+    return result;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "../Model/RubiksCube.h"
+#include "../PatternDatabases/PerimeterDatabase.h"
+
+#ifndef SOLUTIONOPTIMIZER_H
+#define SOLUTIONOPTIMIZER_H
+
+/*
+ * Shortens solutions that are correct but not optimal.
+ *
+ * Moves on one face are merged and cancelled, looking through moves on the
+ * opposite face since those commute, eg- "R L R'" becomes "L". Then every
+ * window of up to maxWindow moves is looked up in a perimeter database, and
+ * is swapped for the database's optimal sequence when that one is shorter.
+ */
+class SolutionOptimizer
+{
+    shared_ptr<const PerimeterDatabase> perimeterDB;
+    size_t maxWindow;
+
+    // Returns the shortest sequence with the same effect as window, which must lie inside the perimeter.
+    [[nodiscard]] vector<RubiksCube::MOVE> solveWindow(span<const RubiksCube::MOVE> window) const;
+
+public:
+    /**
+     * Constructor for the SolutionOptimizer class.
+     *
+     * An empty or missing perimeter database is replaced by one of depth 4
+     * generated in memory, which takes a fraction of a second.
+     *
+     * @param _perimeterDB the table windows are re-solved with
+     * @param _maxWindow the longest window that is re-solved
+     */
+    explicit SolutionOptimizer(shared_ptr<const PerimeterDatabase> _perimeterDB = nullptr, size_t _maxWindow = 8);
+
+    /**
+     * Merges runs of moves on the same face and drops the ones that cancel out.
+     *
+     * @param moves the moves to simplify
+     * @return moves with the same effect, never more of them
+     */
+    [[nodiscard]] static vector<RubiksCube::MOVE> cancelMoves(const vector<RubiksCube::MOVE>& moves);
+
+    /**
+     * Cancels moves and re-solves windows until neither makes the solution any shorter.
+     *
+     * @param moves the moves to optimize
+     * @return moves with the same effect, never more of them
+     */
+    [[nodiscard]] vector<RubiksCube::MOVE> optimize(const vector<RubiksCube::MOVE>& moves) const;
+};
+
+#endif //SOLUTIONOPTIMIZER_H
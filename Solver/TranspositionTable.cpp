@@ -0,0 +1,90 @@
+#include "TranspositionTable.h"
+using namespace std;
+
+namespace
+{
+    constexpr size_t BUCKET_SIZE = 64;
+
+    size_t getNumBuckets(const size_t budgetBytes)
+    {
+        return bit_floor(max<size_t>(1, budgetBytes / BUCKET_SIZE));
+    }
+}
+
+TranspositionTable::TranspositionTable(const size_t budgetBytes, const StoragePlacement placement) :
+    buckets(getNumBuckets(budgetBytes) * BUCKET_SIZE, 0, placement), bucketMask(getNumBuckets(budgetBytes) - 1)
+{
+}
+
+TranspositionTable::Entry* TranspositionTable::getBucket(const PackedCube& state)
+{
+    // Multiplying only carries upwards, so the low bits of the hash depend on few bits of the state.
+    const size_t bucket = (HashPackedCube()(state) >> 20) & bucketMask;
+    return reinterpret_cast<Entry*>(buckets.data() + bucket * BUCKET_SIZE);
+}
+
+bool TranspositionTable::isProvenFailing(const PackedCube& state, const uint8_t depth)
+{
+    ++statistics.probes;
+    const Entry* bucket = this->getBucket(state);
+    for (size_t i = 0; i < ENTRIES_PER_BUCKET; i++)
+    {
+        const Entry& entry = bucket[i];
+        if (entry.depth != 0 && entry.edges == state.edges && entry.corners == state.corners)
+        {
+            if (entry.depth >= depth)
+            {
+                ++statistics.hits;
+                return true;
+            }
+            return false;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::storeFailing(const PackedCube& state, const uint8_t depth)
+{
+    ++statistics.stores;
+    Entry* bucket = this->getBucket(state);
+    Entry* victim = bucket;
+    for (size_t i = 0; i < ENTRIES_PER_BUCKET; i++)
+    {
+        Entry& entry = bucket[i];
+        if (entry.depth != 0 && entry.edges == state.edges && entry.corners == state.corners)
+        {
+            entry.depth = max(entry.depth, depth);
+            return;
+        }
+        if (entry.depth < victim->depth)
+        {
+            victim = &entry;
+        }
+    }
+    // Deeper results save bigger subtrees, so the shallowest entry makes way.
+    if (victim->depth != 0)
+    {
+        if (victim->depth > depth)
+        {
+            return;
+        }
+        ++statistics.replacements;
+    }
+    *victim = {state.edges, static_cast<uint32_t>(state.corners), depth, {}};
+}
+
+size_t TranspositionTable::getNumEntries() const
+{
+    return (bucketMask + 1) * ENTRIES_PER_BUCKET;
+}
+
+const TranspositionStatistics& TranspositionTable::getStatistics() const
+{
+    return statistics;
+}
+
+void TranspositionTable::clear()
+{
+    memset(buckets.data(), 0, buckets.size());
+    statistics = TranspositionStatistics();
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include<bits/stdc++.h>
+#include "../Model/PackedCube.h"
+#include "../PatternDatabases/StorageBuffer.h"
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+struct TranspositionStatistics
+{
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+    // Stores that evicted a different state from a full bucket.
+    uint64_t replacements = 0;
+};
+
+/*
+ * Remembers states already shown to have no solution within some number of moves,
+ * so a depth-first search can skip them when it reaches them again by another path
+ * or in a later iteration. That holds whatever the search started from.
+ *
+ * It is a fixed-size hash table of 64-byte buckets, one cache line each, holding 4
+ * entries. A full bucket evicts its shallowest entry, so the table is lossy but never
+ * wrong. Keys are stored in full, a packed state takes only 67 bits.
+ */
+class TranspositionTable
+{
+    struct Entry
+    {
+        uint64_t edges;
+        uint32_t corners;
+        // Moves proven not to be enough from the state, 0 marks an empty entry.
+        uint8_t depth;
+        uint8_t padding[3];
+    };
+
+    static constexpr size_t ENTRIES_PER_BUCKET = 4;
+    static_assert(sizeof(Entry) * ENTRIES_PER_BUCKET == 64);
+
+    StorageBuffer buckets;
+    size_t bucketMask;
+    TranspositionStatistics statistics;
+
+    [[nodiscard]] Entry* getBucket(const PackedCube& state);
+
+public:
+    /**
+     * Constructor for the TranspositionTable class.
+     *
+     * @param budgetBytes the memory to use, rounded down to a power of two buckets
+     * @param placement the pages to back the table with
+     */
+    explicit TranspositionTable(size_t budgetBytes, StoragePlacement placement = {});
+
+    /**
+     * Returns true if the state is known to have no solution within depth moves.
+     *
+     * @param state the state to look up
+     * @param depth the number of moves left in the search
+     */
+    bool isProvenFailing(const PackedCube& state, uint8_t depth);
+
+    /**
+     * Records that the state has no solution within depth moves.
+     *
+     * @param state the state that was searched
+     * @param depth the number of moves the search had left
+     */
+    void storeFailing(const PackedCube& state, uint8_t depth);
+
+    [[nodiscard]] size_t getNumEntries() const;
+
+    [[nodiscard]] const TranspositionStatistics& getStatistics() const;
+
+    // Forgets every entry and zeroes the statistics.
+    void clear();
+};
+
+#endif //TRANSPOSITIONTABLE_H
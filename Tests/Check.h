@@ -0,0 +1,23 @@
+#pragma once
+#include<bits/stdc++.h>
+using namespace std;
+
+#ifndef CHECK_H
+#define CHECK_H
+
+// Failed checks so far, main returns nonzero if there are any.
+inline int checkFailures = 0;
+
+// Reports a failed condition with where it is, and carries on with the rest of the test.
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+            ++checkFailures; \
+        } \
+    } \
+    while (false)
+
+#endif //CHECK_H
@@ -0,0 +1,81 @@
+#include "Check.h"
+#include "../PatternDatabases/ExternalBFS.h"
+
+namespace
+{
+    // Reachable states at each distance from solved, counted in the half turn metric.
+    const vector<uint64_t> LAYER_SIZES = {1, 18, 243, 3240, 43239, 574908};
+
+    filesystem::path makeWorkDir(const string& name)
+    {
+        const filesystem::path dir = filesystem::temp_directory_path() /
+            ("ExternalBFSTest-" + name + "-" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+        filesystem::create_directories(dir);
+        return dir;
+    }
+
+    bool isEmpty(const filesystem::path& dir)
+    {
+        return filesystem::directory_iterator(dir) == filesystem::directory_iterator();
+    }
+
+    void countsLayersWithinOnePass()
+    {
+        const filesystem::path dir = makeWorkDir("one-pass");
+        ExternalBFS bfs(dir.string(), size_t(256) << 20, 4);
+        CHECK(bfs.run(4) == vector(LAYER_SIZES.begin(), LAYER_SIZES.begin() + 5));
+        CHECK(isEmpty(dir));
+        filesystem::remove_all(dir);
+    }
+
+    // A 1 MiB budget has room for 16 readers, far fewer than the runs of the last layer.
+    void countsLayersWithMultiPassMerge()
+    {
+        const filesystem::path dir = makeWorkDir("multi-pass");
+        ExternalBFS bfs(dir.string(), size_t(1) << 20, 4);
+        uint64_t visited = 0;
+        mutex visitedLock;
+        bfs.setVisitor([&](uint8_t, const PackedCube*, const size_t count)
+        {
+            lock_guard guard(visitedLock);
+            visited += count;
+        });
+        CHECK(bfs.run(5) == LAYER_SIZES);
+        CHECK(visited == accumulate(LAYER_SIZES.begin(), LAYER_SIZES.end(), uint64_t(0)));
+        CHECK(isEmpty(dir));
+        filesystem::remove_all(dir);
+    }
+
+    void removesFilesWhenRunFails()
+    {
+        const filesystem::path dir = makeWorkDir("failure");
+        ExternalBFS bfs(dir.string(), size_t(1) << 20, 2);
+        bfs.setVisitor([](const uint8_t depth, const PackedCube*, size_t)
+        {
+            if (depth == 3)
+            {
+                throw runtime_error("visitor failed");
+            }
+        });
+        bool threw = false;
+        try
+        {
+            bfs.run(4);
+        }
+        catch (const runtime_error&)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(isEmpty(dir));
+        filesystem::remove_all(dir);
+    }
+}
+
+int main()
+{
+    countsLayersWithinOnePass();
+    countsLayersWithMultiPassMerge();
+    removesFilesWhenRunFails();
+    return checkFailures == 0 ? 0 : 1;
+}
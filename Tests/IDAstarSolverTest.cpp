@@ -0,0 +1,99 @@
+#include "Check.h"
+#include "../Model/RubiksCubeBitboard.cpp"
+#include "../Model/ScrambleGenerator.h"
+#include "../Solver/IDASTARSolver.h"
+#include "../Solver/IDDFSSolver.h"
+
+namespace
+{
+    // Corner distances up to depthLimit, the rest of the table left unset as a generator cut short leaves it.
+    shared_ptr<const CornerPatternDatabase> makeCappedCornerDatabase(const uint8_t depthLimit)
+    {
+        auto cornerDB = make_shared<CornerPatternDatabase>();
+        vector<RubiksCubeBitboard> frontier(1);
+        cornerDB->setNumMoves(frontier[0], 0);
+        for (uint8_t depth = 1; depth <= depthLimit; depth++)
+        {
+            vector<RubiksCubeBitboard> next;
+            for (RubiksCubeBitboard& cube : frontier)
+            {
+                for (int i = 0; i < 18; i++)
+                {
+                    const auto move = static_cast<RubiksCube::MOVE>(i);
+                    cube.move(move);
+                    if (cornerDB->getNumMoves(cube) == 0xF)
+                    {
+                        cornerDB->setNumMoves(cube, depth);
+                        next.push_back(cube);
+                    }
+                    cube.invert(move);
+                }
+            }
+            frontier = std::move(next);
+        }
+        cornerDB->setDepthLimit(depthLimit);
+        return cornerDB;
+    }
+
+    RubiksCubeBitboard scramble(const vector<RubiksCube::MOVE>& moves)
+    {
+        RubiksCubeBitboard cube;
+        for (const RubiksCube::MOVE move : moves)
+        {
+            cube.move(move);
+        }
+        return cube;
+    }
+
+    bool solves(RubiksCubeBitboard cube, const vector<RubiksCube::MOVE>& moves)
+    {
+        for (const RubiksCube::MOVE move : moves)
+        {
+            cube.move(move);
+        }
+        return cube.isSolved();
+    }
+
+    // Scrambles of 5 and 6 moves take their corners past a depth-3 table, so most lookups
+    // are unset. Read raw as 15 they made IDA* return solutions several moves too long.
+    void solvesOptimallyWithCappedTable()
+    {
+        const auto cornerDB = makeCappedCornerDatabase(3);
+        CHECK(cornerDB->getUnsetBound() == 4);
+        ScrambleGenerator generator(41);
+        for (int i = 0; i < 12; i++)
+        {
+            RubiksCubeBitboard cube = scramble(generator.randomMoves(5 + i % 2));
+            IDDFSSolver<RubiksCubeBitboard> reference(cube, 6);
+            const size_t optimal = reference.solve().size();
+            for (const bool dual : {false, true})
+            {
+                IDAstarSolver<RubiksCubeBitboard> solver(cube, cornerDB);
+                solver.setDualLookups(dual);
+                const vector<RubiksCube::MOVE> moves = solver.solve();
+                CHECK(moves.size() == optimal);
+                CHECK(solves(cube, moves));
+            }
+        }
+    }
+
+    // A solver asked to solve again must not reuse the closed set or moves of the last search.
+    void solvesAgainFromScratch()
+    {
+        const auto cornerDB = makeCappedCornerDatabase(3);
+        RubiksCubeBitboard cube = scramble(RubiksCube::parseMoves("R U F' L2"));
+        IDAstarSolver<RubiksCubeBitboard> solver(cube, cornerDB);
+        const vector<RubiksCube::MOVE> first = solver.solve();
+        solver.rubiksCube = cube;
+        const vector<RubiksCube::MOVE> second = solver.solve();
+        CHECK(first.size() == 4);
+        CHECK(second == first);
+    }
+}
+
+int main()
+{
+    solvesOptimallyWithCappedTable();
+    solvesAgainFromScratch();
+    return checkFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include "Check.h"
+#include "../Model/ScrambleGenerator.h"
+#include "../Service/SolverEngine.h"
+
+namespace
+{
+    filesystem::path makeTableFile(const string& name)
+    {
+        return filesystem::temp_directory_path() /
+            ("PocketCubeTest-" + name + "-" + to_string(chrono::steady_clock::now().time_since_epoch().count()) + ".db");
+    }
+
+    RubiksCube2x2 applyMoves(RubiksCube2x2 cube, const vector<RubiksCube::MOVE>& moves)
+    {
+        for (const RubiksCube::MOVE move : moves)
+        {
+            cube.move(move);
+        }
+        return cube;
+    }
+
+    void solvesThroughTheEngine(const shared_ptr<const RubiksCube2x2Solver>& solver)
+    {
+        const SolverEngine engine(nullptr, nullptr, 7, nullptr, 1, 0, 10000000, solver);
+        CHECK(SolverEngine::parseEngine("pocket") == ENGINE::POCKET);
+
+        const SolveResult result = engine.solve(RubiksCube::parseMoves("R U F'"), ENGINE::POCKET);
+        CHECK(result.solved);
+        CHECK(result.moves.size() == 3);
+
+        // L acts as R in the frame where the down-back-left corner stays put.
+        const SolveResult mirrored = engine.solve(RubiksCube::parseMoves("L D2"), ENGINE::POCKET);
+        CHECK(mirrored.solved);
+        CHECK(mirrored.moves.size() == 2);
+
+        ScrambleGenerator generator(7);
+        for (int i = 0; i < 200; i++)
+        {
+            const vector<RubiksCube::MOVE> scramble = generator.randomMoves(20);
+            const SolveResult random = engine.solve(scramble, ENGINE::POCKET);
+            CHECK(random.solved);
+            CHECK(random.moves.size() <= RubiksCube2x2Solver::MAX_MOVES);
+            CHECK(applyMoves(applyMoves({}, scramble), random.moves).isSolved());
+        }
+
+        const SolverEngine withoutTable(nullptr, nullptr);
+        bool threw = false;
+        try
+        {
+            (void) withoutTable.solve(RubiksCube::parseMoves("R"), ENGINE::POCKET);
+        }
+        catch (const invalid_argument&)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    void batchMatchesSingleSolves(const RubiksCube2x2Solver& solver)
+    {
+        constexpr size_t N = 100;
+        ScrambleGenerator generator(11);
+        vector<RubiksCube2x2> cubes;
+        for (size_t i = 0; i < N; i++)
+        {
+            cubes.push_back(RubiksCube2x2::fromIndex(static_cast<uint32_t>(generator.nextBelow(RubiksCube2x2::NUM_STATES))));
+        }
+        vector<RubiksCube::MOVE> moves(N * RubiksCube2x2Solver::MAX_MOVES);
+        vector<uint8_t> numMoves(N);
+        solver.solveBatch(cubes.data(), N, moves.data(), numMoves.data(), 2);
+        for (size_t i = 0; i < N; i++)
+        {
+            CHECK(numMoves[i] == solver.solve(cubes[i]).size());
+            const vector<RubiksCube::MOVE> solution(moves.begin() + i * RubiksCube2x2Solver::MAX_MOVES,
+                                                    moves.begin() + i * RubiksCube2x2Solver::MAX_MOVES + numMoves[i]);
+            CHECK(applyMoves(cubes[i], solution).isSolved());
+        }
+    }
+
+    // A table with one state's entry knocked out must refuse that state instead of
+    // returning moves that do not solve it.
+    void rejectsDamagedEntries()
+    {
+        RubiksCube2x2Database database;
+        database.generate();
+        const RubiksCube2x2 damaged = applyMoves({}, RubiksCube::parseMoves("R U"));
+        vector<uint8_t> data(database.data(), database.data() + database.storageSize());
+        const uint32_t index = damaged.getIndex();
+        data[index / 2] |= index % 2 ? 0x0F : 0xF0;
+        database.fromData(data.data(), database.getNumItems() - 1);
+        const filesystem::path file = makeTableFile("damaged");
+        database.toFile(file.string());
+
+        const RubiksCube2x2Solver solver(file.string());
+        bool threw = false;
+        try
+        {
+            (void) solver.solve(damaged);
+        }
+        catch (const runtime_error&)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+
+        // Its neighbours have no child one move closer left on their path.
+        const RubiksCube2x2 beyond = applyMoves(damaged, RubiksCube::parseMoves("F"));
+        const array<RubiksCube2x2, 2> cubes = {damaged, beyond};
+        array<RubiksCube::MOVE, 2 * RubiksCube2x2Solver::MAX_MOVES> moves{};
+        array<uint8_t, 2> numMoves{};
+        solver.solveBatch(cubes.data(), cubes.size(), moves.data(), numMoves.data());
+        CHECK(numMoves[0] == RubiksCube2x2Solver::UNSOLVED);
+        CHECK(numMoves[1] == RubiksCube2x2Solver::UNSOLVED);
+        filesystem::remove(file);
+    }
+}
+
+int main()
+{
+    const filesystem::path file = makeTableFile("table");
+    const auto solver = make_shared<const RubiksCube2x2Solver>(file.string());
+    solvesThroughTheEngine(solver);
+    batchMatchesSingleSolves(*solver);
+    rejectsDamagedEntries();
+    filesystem::remove(file);
+    return checkFailures == 0 ? 0 : 1;
+}
@@ -1,25 +1,453 @@
-#include "Model/RubiksCubeBitboard.cpp"
-#include "Solver/IDASTARSolver.h"
+#include "Model/RubiksCube.h"
+#include "Model/ScrambleGenerator.h"
+#include "PatternDatabases/DatabaseAnalyzer.h"
+#include "PatternDatabases/DatabaseRegistry.h"
+#include "PatternDatabases/NibbleArrayStress.h"
+#include "Service/BoundedQueue.h"
+#include "Service/DatabaseLoader.h"
+#include "Service/Json.h"
+#include "Service/Protocol.h"
+#include "Service/SolverDaemon.h"
+#include "Service/SolverEngine.h"
+#include "Solver/LookupBenchmark.h"
+#include <csignal>
+#include <unistd.h>
 
-int main()
+namespace
 {
-    RubiksCubeBitboard cube;
+    struct Options
+    {
+        ENGINE engine = ENGINE::IDASTAR;
+        unsigned threads = max(1u, thread::hardware_concurrency());
+        string cornerFileName = "Databases/cornerDepth5V1.txt";
+        string perimeterFileName;
+        string pocketFileName = "Databases/pocketCube.db";
+        bool backgroundLoad = false;
+        string inputFileName;
+        int iddfsMaxDepth = 7;
+        int64_t deadlineMs = 0;
+        bool optimize = false;
+        unsigned bfsThreads = 1;
+        size_t transpositionMb = 0;
+        uint64_t nodeBudget = 10000000;
+        SearchTuning tuning;
+        string serveSocket;
+        string connectSocket;
+        uint64_t generateCount = 0;
+        optional<uint64_t> seed;
+        // 25 for --generate and 8 for --bench-lookups unless given.
+        optional<unsigned> scrambleLength;
+        string analyzeFileName;
+        uint64_t analyzeSamples = 100000;
+        uint64_t stressRounds = 0;
+        uint64_t benchScrambles = 0;
+    };
+
+    struct Job
+    {
+        uint64_t line;
+        string scramble;
+    };
+
+    void printUsage(const char* program)
+    {
+        cerr << "Usage: " << program << " [options] [scramble-file]\n"
+            << "Reads one scramble in WCA notation per line, from stdin unless a file is given,\n"
+            << "and writes one JSON object per solved line as soon as it is done.\n"
+            << "With --serve it instead keeps the databases loaded and solves requests sent to\n"
+            << "a Unix socket, and with --connect it sends its lines to such a daemon.\n"
+            << "With --generate it writes random scrambles in the same format instead, and with\n"
+            << "--analyze it reports on a database file, for people on stderr and as JSON on stdout.\n"
+            << "--stress-nibbles checks and times the concurrent nibble array the same way, and\n"
+            << "--bench-lookups times batched against per-child corner lookups.\n\n"
+            << "  --engine bfs|iddfs|idastar|auto|pocket\n"
+            << "                              solver to use (default idastar), auto predicts the idastar\n"
+            << "                              effort and falls back to the undone scramble when too high,\n"
+            << "                              pocket solves the scramble as a 2x2x2\n"
+            << "  --threads N                 worker threads (default: all cores)\n"
+            << "  --corner-db PATH            corner pattern database for idastar\n"
+            << "  --perimeter-db PATH         optional perimeter database for idastar\n"
+            << "  --pocket-db PATH            2x2x2 distance table for pocket, generated there if missing\n"
+            << "  --background-load           start solving at once and load the corner database meanwhile,\n"
+            << "                              idastar searches on the perimeter alone and auto falls back till then\n"
+            << "  --max-depth N               deepest search for iddfs (default 7)\n"
+            << "  --deadline-ms N             give up on a scramble after N ms (default: never)\n"
+            << "  --bfs-threads N             threads each bfs solve is split across (default 1)\n"
+            << "  --tt-mb N                   transposition table of N MiB per iddfs solve (default: none)\n"
+            << "  --node-budget N             most predicted nodes auto searches to the end (default 1e7)\n"
+            << "  --dual-lookups              also look up each state's inverse, only useful for partial tables\n"
+            << "  --per-child-lookups         read each child's corner entry on its own instead of batched\n"
+            << "  --child-order estimate|generated|history\n"
+            << "                              order of idastar nodes with equal f (default estimate),\n"
+            << "                              history breaks estimate ties by moves that helped before\n"
+            << "  --optimize                  shorten solutions by cancelling and re-solving moves\n"
+            << "  --serve PATH                run as a daemon listening on the socket PATH\n"
+            << "  --connect PATH              send scrambles to the daemon at PATH\n"
+            << "  --generate N                write N random scrambles and exit\n"
+            << "  --seed N                    seed for --generate, --analyze and the benchmarks (default: random)\n"
+            << "  --scramble-length N         moves per generated or benchmarked scramble (default 25, 8)\n"
+            << "  --analyze PATH              report on the nibble database at PATH and exit\n"
+            << "  --samples N                 random states --analyze checks consistency on (default 100000)\n"
+            << "  --stress-nibbles N          run N rounds of the concurrent nibble array stress test and exit\n"
+            << "  --bench-lookups N           solve N random scrambles with batched and per-child lookups and exit\n";
+    }
+
+    void setChildOrder(SearchTuning& tuning, const string& order)
+    {
+        if (order != "estimate" && order != "generated" && order != "history")
+        {
+            throw invalid_argument("Unknown child order \"" + order + "\", expected estimate, generated or history");
+        }
+        tuning.orderByEstimate = order != "generated";
+        tuning.useHistory = order == "history";
+    }
+
+    Options parseOptions(const int argc, char* argv[])
+    {
+        Options options;
+        for (int i = 1; i < argc; i++)
+        {
+            const string arg = argv[i];
+            const auto value = [&]
+            {
+                if (i + 1 >= argc)
+                {
+                    throw invalid_argument("Missing value for " + arg);
+                }
+                return string(argv[++i]);
+            };
+            if (arg == "--engine") options.engine = SolverEngine::parseEngine(value());
+            else if (arg == "--threads") options.threads = max(1, stoi(value()));
+            else if (arg == "--corner-db") options.cornerFileName = value();
+            else if (arg == "--perimeter-db") options.perimeterFileName = value();
+            else if (arg == "--pocket-db") options.pocketFileName = value();
+            else if (arg == "--background-load") options.backgroundLoad = true;
+            else if (arg == "--max-depth") options.iddfsMaxDepth = stoi(value());
+            else if (arg == "--deadline-ms") options.deadlineMs = max<int64_t>(0, stoll(value()));
+            else if (arg == "--bfs-threads") options.bfsThreads = max(1, stoi(value()));
+            else if (arg == "--tt-mb") options.transpositionMb = max(0, stoi(value()));
+            else if (arg == "--node-budget") options.nodeBudget = static_cast<uint64_t>(stod(value()));
+            else if (arg == "--dual-lookups") options.tuning.dualLookups = true;
+            else if (arg == "--per-child-lookups") options.tuning.batchedLookups = false;
+            else if (arg == "--child-order") setChildOrder(options.tuning, value());
+            else if (arg == "--optimize") options.optimize = true;
+            else if (arg == "--serve") options.serveSocket = value();
+            else if (arg == "--connect") options.connectSocket = value();
+            else if (arg == "--generate") options.generateCount = stoull(value());
+            else if (arg == "--seed") options.seed = stoull(value());
+            else if (arg == "--analyze") options.analyzeFileName = value();
+            else if (arg == "--samples") options.analyzeSamples = stoull(value());
+            else if (arg == "--bench-lookups") options.benchScrambles = max<uint64_t>(1, stoull(value()));
+            else if (arg == "--stress-nibbles") options.stressRounds = max<uint64_t>(1, stoull(value()));
+            else if (arg == "--scramble-length") options.scrambleLength = static_cast<unsigned>(max(0, stoi(value())));
+            else if (arg == "--help" || arg == "-h")
+            {
+                printUsage(argv[0]);
+                exit(0);
+            }
+            else if (arg.starts_with("--")) throw invalid_argument("Unknown option " + arg);
+            else options.inputFileName = arg;
+        }
+        return options;
+    }
+
+    string formatResult(const Job& job, const ENGINE engine, const SolveResult& result)
+    {
+        return "{\"line\":" + to_string(job.line) + ",\"scramble\":" + toJsonString(job.scramble) + "," +
+            SolverEngine::toJsonMembers(result, engine) + "}\n";
+    }
+
+    string formatError(const Job& job, const string& error)
+    {
+        return "{\"line\":" + to_string(job.line) + ",\"scramble\":" + toJsonString(job.scramble) +
+            ",\"error\":" + toJsonString(error) + "}\n";
+    }
+
+    // Writes generateCount scrambles, one per line in WCA notation, ready to be read back as input.
+    int runGenerator(const Options& options)
+    {
+        ScrambleGenerator generator(options.seed.value_or(ScrambleGenerator::randomSeed()));
+        string line;
+        for (uint64_t i = 0; i < options.generateCount; i++)
+        {
+            line.clear();
+            for (const RubiksCube::MOVE move : generator.randomMoves(options.scrambleLength.value_or(25)))
+            {
+                if (!line.empty()) line += ' ';
+                line += RubiksCube::getMove(move);
+            }
+            cout << line << "\n";
+        }
+        cout << flush;
+        return 0;
+    }
+
+    SolverDaemon* runningDaemon = nullptr;
+
+    void stopDaemon(int)
+    {
+        if (runningDaemon)
+        {
+            runningDaemon->stop();
+        }
+    }
+
+    // Sends every line to the daemon as a solve request and prints the responses.
+    int runClient(const Options& options, istream& input)
+    {
+        const int fd = connectUnixSocket(options.connectSocket);
+        string line, response;
+        uint64_t lineNumber = 0;
+        while (getline(input, line))
+        {
+            ++lineNumber;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.find_first_not_of(" \t") == string::npos) continue;
+            writeFrame(fd, line == "METRICS"
+                               ? line
+                               : "SOLVE " + to_string(lineNumber) + " " + SolverEngine::getEngineName(options.engine) +
+                               " " + to_string(options.deadlineMs) + " " + line);
+            if (!readFrame(fd, response))
+            {
+                cerr << "The daemon closed the connection\n";
+                close(fd);
+                return 1;
+            }
+            cout << response << "\n" << flush;
+        }
+        close(fd);
+        return 0;
+    }
+}
+
+int main(const int argc, char* argv[])
+{
+    ios::sync_with_stdio(false);
+    Options options;
+    try
+    {
+        options = parseOptions(argc, argv);
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (options.generateCount > 0)
+    {
+        return runGenerator(options);
+    }
+    if (options.stressRounds > 0)
+    {
+        const NibbleStressReport report = stressNibbleArray(options.threads, options.stressRounds,
+                                                            options.seed.value_or(ScrambleGenerator::randomSeed()));
+        printNibbleStressReport(cerr, report);
+        cout << toJson(report) << endl;
+        return report.mismatches == 0 ? 0 : 1;
+    }
+    if (options.benchScrambles > 0)
+    {
+        try
+        {
+            const auto corners = DatabaseRegistry::global().acquire<CornerPatternDatabase>(options.cornerFileName);
+            if (!corners)
+            {
+                cerr << "Cannot open corner database " << options.cornerFileName << "\n";
+                return 1;
+            }
+            const LookupBenchmarkReport report = benchmarkLookups(
+                corners, options.benchScrambles, options.scrambleLength.value_or(8),
+                options.seed.value_or(ScrambleGenerator::randomSeed()));
+            printLookupBenchmarkReport(cerr, report);
+            cout << toJson(report) << endl;
+            return 0;
+        }
+        catch (const exception& e)
+        {
+            cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+    if (!options.analyzeFileName.empty())
+    {
+        try
+        {
+            const DatabaseReport report = analyzeDatabase(options.analyzeFileName, options.threads,
+                                                          options.analyzeSamples,
+                                                          options.seed.value_or(ScrambleGenerator::randomSeed()));
+            printDatabaseReport(cerr, report);
+            cout << toJson(report) << endl;
+            return report.violations == 0 ? 0 : 1;
+        }
+        catch (const exception& e)
+        {
+            cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    ifstream inputFile;
+    if (!options.inputFileName.empty())
+    {
+        inputFile.open(options.inputFileName);
+        if (!inputFile.is_open())
+        {
+            cerr << "Cannot open " << options.inputFileName << "\n";
+            return 1;
+        }
+    }
+    istream& input = options.inputFileName.empty() ? cin : inputFile;
 
-    const vector<RubiksCube::MOVE> shuffleMoves = cube.randomShuffleCube(5);
-    cube.print();
-    for (const auto move : shuffleMoves)
+    if (!options.connectSocket.empty())
     {
-        cout << RubiksCubeBitboard::getMove(move) << " ";
+        try
+        {
+            return runClient(options, input);
+        }
+        catch (const exception& e)
+        {
+            cerr << e.what() << "\n";
+            return 1;
+        }
     }
-    cout << endl << endl;
 
-    const string fileName = R"(C:\Users\arijitbiswas\CLionProjects\RubiksCubeSolver\Databases\cornerDepth5V1.txt)";
-    IDAstarSolver<RubiksCubeBitboard, HashBitboard> idaStarSolver(cube, fileName);
-    const vector<RubiksCube::MOVE> moves = idaStarSolver.solve();
-    idaStarSolver.rubiksCube.print();
-    for (const auto move : moves)
+    // The databases are loaded once and shared read-only by every worker. A daemon started
+    // with another --engine skips them, and then answers requests for the engines needing them with an error.
+    // With --background-load the corner database is put in its slot whenever it is ready, the
+    // perimeter database is small enough to wait for.
+    shared_ptr<DatabaseSlot<CornerPatternDatabase>> cornerSlot;
+    unique_ptr<DatabaseLoader> cornerLoader;
+    shared_ptr<const PerimeterDatabase> perimeterDB;
+    shared_ptr<const RubiksCube2x2Solver> pocketSolver;
+    try
+    {
+        if (options.engine == ENGINE::POCKET)
+        {
+            // The table is generated in well under a second when the file is missing.
+            if (const filesystem::path directory = filesystem::path(options.pocketFileName).parent_path();
+                !directory.empty())
+            {
+                filesystem::create_directories(directory);
+            }
+            pocketSolver = make_shared<const RubiksCube2x2Solver>(options.pocketFileName);
+        }
+        if (options.engine == ENGINE::IDASTAR || options.engine == ENGINE::AUTO)
+        {
+            cornerSlot = make_shared<DatabaseSlot<CornerPatternDatabase>>();
+            if (options.backgroundLoad)
+            {
+                cornerLoader = make_unique<DatabaseLoader>(
+                    cornerSlot, options.cornerFileName, VERIFY_MODE::DEFAULT, [](const DatabaseLoader& loader)
+                    {
+                        if (loader.getState() == LOAD_STATE::LOADED)
+                        {
+                            cerr << "Corner database loaded in " << loader.getLoadSeconds() << "s\n";
+                        }
+                        else
+                        {
+                            cerr << loader.getError() << ", solving without it\n";
+                        }
+                    });
+            }
+            else
+            {
+                const auto corners = DatabaseRegistry::global().acquire<CornerPatternDatabase>(options.cornerFileName);
+                if (!corners)
+                {
+                    cerr << "Cannot open corner database " << options.cornerFileName << "\n";
+                    return 1;
+                }
+                cornerSlot->set(corners);
+            }
+            if (!options.perimeterFileName.empty())
+            {
+                perimeterDB = DatabaseRegistry::global().acquire<PerimeterDatabase>(options.perimeterFileName);
+                if (!perimeterDB)
+                {
+                    cerr << "Cannot open perimeter database " << options.perimeterFileName << "\n";
+                    return 1;
+                }
+            }
+        }
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+    shared_ptr<const SolutionOptimizer> optimizer;
+    if (options.optimize)
+    {
+        optimizer = make_shared<const SolutionOptimizer>(perimeterDB);
+    }
+    const SolverEngine engine(cornerSlot, perimeterDB, options.iddfsMaxDepth, optimizer, options.bfsThreads,
+                              options.transpositionMb << 20, options.nodeBudget, pocketSolver, options.tuning);
+
+    if (!options.serveSocket.empty())
+    {
+        SolverDaemon daemon(engine, options.threads, options.threads * 4);
+        runningDaemon = &daemon;
+        signal(SIGINT, stopDaemon);
+        signal(SIGTERM, stopDaemon);
+        try
+        {
+            daemon.serve(options.serveSocket);
+        }
+        catch (const exception& e)
+        {
+            cerr << e.what() << "\n";
+            return 1;
+        }
+        runningDaemon = nullptr;
+        return 0;
+    }
+
+    // A few jobs per worker keeps them busy, while a slow consumer stalls the reader instead of growing the queue.
+    BoundedQueue<Job> jobs(options.threads * 4);
+    mutex outputLock;
+    vector<thread> workers;
+    for (unsigned t = 0; t < options.threads; t++)
+    {
+        workers.emplace_back([&]
+        {
+            while (const optional<Job> job = jobs.pop())
+            {
+                string output;
+                try
+                {
+                    optional<chrono::steady_clock::time_point> deadline;
+                    if (options.deadlineMs > 0)
+                    {
+                        deadline = chrono::steady_clock::now() + chrono::milliseconds(options.deadlineMs);
+                    }
+                    output = formatResult(*job, options.engine,
+                                          engine.solve(RubiksCube::parseMoves(job->scramble), options.engine, deadline));
+                }
+                catch (const exception& e)
+                {
+                    output = formatError(*job, e.what());
+                }
+                lock_guard guard(outputLock);
+                cout << output << flush;
+            }
+        });
+    }
+
+    string line;
+    uint64_t lineNumber = 0;
+    while (getline(input, line))
+    {
+        ++lineNumber;
+        if (line.find_first_not_of(" \t\r") == string::npos) continue;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        jobs.push({lineNumber, std::move(line)});
+    }
+    jobs.close();
+    for (thread& worker : workers)
     {
-        cout << RubiksCubeBitboard::getMove(move) << " ";
+        worker.join();
     }
-    cout << endl;
+    return 0;
 }